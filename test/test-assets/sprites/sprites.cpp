@@ -187,14 +187,14 @@ void Player::changeAnimation() {
 
 void Player::setHeadingAngle(float headingAngle){
     this->headingAngle = headingAngle;
-    float angleRad = headingAngle * (3.14f / 180.f);
+    float angleRad = headingAngle * Constants::DEG_TO_RAD;
     directionVector.x = std::cos(angleRad);
     directionVector.y = std::sin(angleRad);
 }
 
 // calculates obstacle's direction vector when bullet is made 
 void Obstacle::setDirectionVector(float angle) {
-    float angleRad = angle * (3.14f / 180.f);
+    float angleRad = angle * Constants::DEG_TO_RAD;
     directionVector.x = std::cos(angleRad);
     directionVector.y = std::sin(angleRad);
     log_info("Obstacle direction vector set based on angle " + std::to_string(angle));
@@ -0,0 +1,94 @@
+#include "chunkstreamer.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+ChunkStreamer::ChunkStreamer(const std::filesystem::path& filePath, uint64_t recordsOffset, uint64_t recordSize, size_t chunkCount)
+    : recordsOffset(recordsOffset), recordSize(recordSize), chunkCount(chunkCount), chunkStates(chunkCount, IDLE) {
+
+    if (recordSize < sizeof(tilemapfile::ChunkRecord)) throw std::invalid_argument("Chunk records are smaller than a chunk");
+
+    fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) throw std::runtime_error("Unable to open file: " + filePath.string());
+
+    ioThread = std::thread(&ChunkStreamer::ioLoop, this);
+    log_info("Chunk streamer started for " + filePath.string());
+}
+
+ChunkStreamer::~ChunkStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    if (ioThread.joinable()) ioThread.join();
+    if (fileDescriptor >= 0) ::close(fileDescriptor);
+}
+
+void ChunkStreamer::setRequests(const std::vector<size_t>& chunkIndices) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.clear();
+        for (size_t chunkIndex : chunkIndices) {
+            if (chunkIndex < chunkCount && chunkStates[chunkIndex] == IDLE) requests.push_back(chunkIndex);
+        }
+    }
+    if (!chunkIndices.empty()) wakeCondition.notify_one();
+}
+
+void ChunkStreamer::takeLoaded(std::vector<LoadedChunk>& loadedChunks) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& chunk : loaded) {
+        chunkStates[chunk.index] = IDLE; // the owner installs it now, so it can be asked for again once evicted
+        loadedChunks.push_back(std::move(chunk));
+    }
+    loaded.clear();
+}
+
+std::unique_ptr<tilemapfile::ChunkRecord> ChunkStreamer::loadNow(size_t chunkIndex) {
+    auto record = std::make_unique<tilemapfile::ChunkRecord>();
+    if (!readRecord(chunkIndex, *record)) return nullptr;
+    return record;
+}
+
+void ChunkStreamer::ioLoop() {
+    while (true) {
+        size_t chunkIndex = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+            chunkIndex = requests.front();
+            requests.pop_front();
+            chunkStates[chunkIndex] = IN_FLIGHT;
+        }
+
+        // the read happens without the lock so a new request list never waits on the disk
+        auto record = std::make_unique<tilemapfile::ChunkRecord>();
+        if (!readRecord(chunkIndex, *record)) {
+            log_warning("Failed to stream tile map chunk " + std::to_string(chunkIndex) + ", it stays a wall");
+            std::lock_guard<std::mutex> lock(mutex);
+            chunkStates[chunkIndex] = FAILED;
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        loaded.push_back({ chunkIndex, std::move(record) });
+    }
+}
+
+bool ChunkStreamer::readRecord(size_t chunkIndex, tilemapfile::ChunkRecord& record) const {
+    if (chunkIndex >= chunkCount) return false;
+
+    uint8_t* destination = reinterpret_cast<uint8_t*>(&record);
+    size_t remaining = sizeof(record);
+    off_t offset = static_cast<off_t>(recordsOffset + chunkIndex * recordSize);
+    while (remaining > 0) {
+        ssize_t bytesRead = ::pread(fileDescriptor, destination, remaining, offset);
+        if (bytesRead <= 0) return false;
+        destination += bytesRead;
+        remaining -= static_cast<size_t>(bytesRead);
+        offset += bytesRead;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+//
+//  chunkstreamer.hpp
+//
+//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+
+#include "../../test-logging/log.hpp"
+#include "tilemapfile.hpp"
+
+/* ChunkStreamer reads chunk records of a binary tile map on its own I/O thread. the owner hands it the chunks it wants
+in priority order (replacing the previous list, so stale requests are dropped) and collects finished chunks whenever it
+likes; nothing on the owner's side ever waits for the disk except loadNow */
+class ChunkStreamer {
+public:
+    struct LoadedChunk {
+        size_t index;
+        std::unique_ptr<tilemapfile::ChunkRecord> cells;
+    };
+
+    // recordsOffset and recordSize come from the file's header, chunkCount bounds the requests
+    explicit ChunkStreamer(const std::filesystem::path& filePath, uint64_t recordsOffset, uint64_t recordSize, size_t chunkCount); // throws if the file can't be opened
+    ~ChunkStreamer();
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    // most wanted first; chunks already being read, waiting to be taken or that failed to read are skipped, so none is read twice
+    void setRequests(const std::vector<size_t>& chunkIndices);
+    void takeLoaded(std::vector<LoadedChunk>& loadedChunks); // appends everything finished since the last call
+    std::unique_ptr<tilemapfile::ChunkRecord> loadNow(size_t chunkIndex); // reads on the calling thread, null on failure
+
+private:
+    void ioLoop();
+    bool readRecord(size_t chunkIndex, tilemapfile::ChunkRecord& record) const;
+
+    int fileDescriptor = -1;
+    uint64_t recordsOffset {};
+    uint64_t recordSize {};
+    size_t chunkCount {};
+
+    enum ChunkState : uint8_t { IDLE, IN_FLIGHT, FAILED }; // IN_FLIGHT from leaving the request list until takeLoaded hands it out
+
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::deque<size_t> requests;
+    std::vector<LoadedChunk> loaded;
+    std::vector<ChunkState> chunkStates; // per chunk, guarded by mutex
+    bool stopping = false;
+    std::thread ioThread;
+};
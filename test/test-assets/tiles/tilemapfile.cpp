@@ -0,0 +1,184 @@
+#include "tilemapfile.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tilemapfile {
+    namespace {
+        bool isBlock4Open(const uint32_t* walkableRows, size_t blockX, size_t blockY) {
+            const uint32_t* rows = walkableRows + blockY * 4;
+            return ((rows[0] & rows[1] & rows[2] & rows[3]) >> (blockX * 4) & 0xFu) == 0xFu;
+        }
+
+        bool isBlock16Open(uint64_t blocks4, size_t blockX, size_t blockY) {
+            uint64_t rowMask = uint64_t(0xF) << (blockX * 4); // the four 4x4 blocks of one row inside the 16x16 block
+            for (size_t row = blockY * 4; row < blockY * 4 + 4; ++row) {
+                if (((blocks4 >> (row * 8)) & rowMask) != rowMask) return false;
+            }
+            return true;
+        }
+    }
+
+    OpenBlocks computeOpenBlocks(const uint32_t* walkableRows) {
+        static_assert(chunkSize == 32, "open blocks are laid out for 32x32 chunks");
+        OpenBlocks blocks {};
+        for (size_t blockY = 0; blockY < 8; ++blockY) {
+            for (size_t blockX = 0; blockX < 8; ++blockX) {
+                if (isBlock4Open(walkableRows, blockX, blockY)) blocks.blocks4 |= uint64_t(1) << (blockY * 8 + blockX);
+            }
+        }
+        for (size_t blockY = 0; blockY < 2; ++blockY) {
+            for (size_t blockX = 0; blockX < 2; ++blockX) {
+                if (isBlock16Open(blocks.blocks4, blockX, blockY)) blocks.blocks16 |= uint8_t(1) << (blockY * 2 + blockX);
+            }
+        }
+        return blocks;
+    }
+
+    void updateOpenBlocks(OpenBlocks& blocks, const uint32_t* walkableRows, size_t localX, size_t localY) {
+        size_t blockX = localX / 4, blockY = localY / 4;
+        uint64_t bit4 = uint64_t(1) << (blockY * 8 + blockX);
+        blocks.blocks4 = isBlock4Open(walkableRows, blockX, blockY) ? (blocks.blocks4 | bit4) : (blocks.blocks4 & ~bit4);
+
+        blockX = localX / 16, blockY = localY / 16;
+        uint8_t bit16 = uint8_t(1) << (blockY * 2 + blockX);
+        blocks.blocks16 = isBlock16Open(blocks.blocks4, blockX, blockY) ? (blocks.blocks16 | bit16) : (blocks.blocks16 & ~bit16);
+    }
+
+    bool isBinaryTileMap(const std::filesystem::path& filePath) {
+        std::ifstream fileStream(filePath, std::ios::binary);
+        char fileMagic[sizeof(magic)] {};
+        return fileStream.read(fileMagic, sizeof(fileMagic)) && std::memcmp(fileMagic, magic, sizeof(magic)) == 0;
+    }
+
+    std::string validateHeader(const Header& header, uint64_t fileSize) {
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) return "not a binary tile map";
+        if (header.version != version) return "unsupported version " + std::to_string(header.version) + ", convert the map again";
+        if (header.endianCheck != endianCheck) return "written with a different byte order";
+        if (header.headerSize != sizeof(Header)) return "unexpected header size " + std::to_string(header.headerSize);
+        if (header.chunkSize != chunkSize) return "unsupported chunk size " + std::to_string(header.chunkSize);
+        if (header.cellBytes != 1 && header.cellBytes != 2) return "unsupported cell size " + std::to_string(header.cellBytes);
+        if (header.chunkRecordSize != chunkRecordSize(header.cellBytes)) return "unexpected chunk record size";
+        if (header.width == 0 || header.height == 0) return "empty map";
+        if (header.cellsOffset % 64 != 0) return "misaligned cell data";
+        if (header.typeTableOffset + uint64_t(header.tileTypeCount) * sizeof(TileTypeRecord) > header.cellsOffset) return "type table overlaps the cells";
+
+        uint64_t chunks = uint64_t((header.width + chunkSize - 1) / chunkSize) * ((header.height + chunkSize - 1) / chunkSize);
+        if (header.cellsOffset + chunks * header.chunkRecordSize > fileSize) return "file is truncated";
+        return std::string();
+    }
+
+    std::vector<uint16_t> readTextTileMap(const std::filesystem::path& filePath, size_t& width, size_t& height) {
+        std::ifstream fileStream(filePath);
+        if (!fileStream.is_open()) {
+            throw std::runtime_error("Unable to open file: " + filePath.string());
+        }
+
+        std::vector<std::vector<uint16_t>> rows;
+        std::string line;
+        width = 0;
+        while (std::getline(fileStream, line)) {
+            std::istringstream lineStream(line);
+            std::vector<uint16_t> row;
+            unsigned long tileIndex = 0;
+            while (lineStream >> tileIndex) {
+                if (tileIndex >= noTile16) throw std::out_of_range("Tile index out of bounds: " + std::to_string(tileIndex));
+                row.push_back(static_cast<uint16_t>(tileIndex));
+            }
+            if (row.empty()) continue;
+            width = std::max(width, row.size());
+            rows.push_back(std::move(row));
+        }
+        height = rows.size();
+
+        std::vector<uint16_t> cells(width * height, noTile16); // short rows are padded with missing tiles
+        for (size_t y = 0; y < height; ++y) std::copy(rows[y].begin(), rows[y].end(), cells.begin() + y * width);
+        return cells;
+    }
+
+    void writeBinaryTileMap(const std::filesystem::path& filePath, size_t width, size_t height, const std::vector<uint16_t>& cells, const std::vector<TileTypeRecord>& tileTypes) {
+        if (cells.size() != width * height) throw std::invalid_argument("cell count doesn't match the map size");
+        if (tileTypes.size() >= noTile16) throw std::invalid_argument("too many tile types");
+
+        Header header {};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.endianCheck = endianCheck;
+        header.headerSize = sizeof(Header);
+        header.width = static_cast<uint32_t>(width);
+        header.height = static_cast<uint32_t>(height);
+        header.chunkSize = chunkSize;
+        header.cellBytes = tileTypes.size() < noTile8 ? 1 : 2;
+        header.tileTypeCount = static_cast<uint16_t>(tileTypes.size());
+        header.typeTableOffset = sizeof(Header);
+        header.cellsOffset = (header.typeTableOffset + tileTypes.size() * sizeof(TileTypeRecord) + 63) & ~uint64_t(63);
+        header.chunkRecordSize = chunkRecordSize(header.cellBytes);
+
+        std::ofstream fileStream(filePath, std::ios::binary | std::ios::trunc);
+        if (!fileStream.is_open()) {
+            throw std::runtime_error("Unable to open file: " + filePath.string());
+        }
+        fileStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        fileStream.write(reinterpret_cast<const char*>(tileTypes.data()), tileTypes.size() * sizeof(TileTypeRecord));
+        std::vector<char> padding(header.cellsOffset - header.typeTableOffset - tileTypes.size() * sizeof(TileTypeRecord), 0);
+        fileStream.write(padding.data(), padding.size());
+
+        size_t chunksX = (width + chunkSize - 1) / chunkSize, chunksY = (height + chunkSize - 1) / chunkSize;
+        std::vector<uint8_t> record(header.chunkRecordSize);
+        uint16_t noTile = header.cellBytes == 1 ? noTile8 : noTile16;
+
+        for (size_t chunkY = 0; chunkY < chunksY; ++chunkY) {
+            for (size_t chunkX = 0; chunkX < chunksX; ++chunkX) {
+                uint8_t* cellBytes = record.data();
+                uint32_t walkableRows[chunkSize] {};
+
+                for (size_t localY = 0; localY < chunkSize; ++localY) {
+                    for (size_t localX = 0; localX < chunkSize; ++localX) {
+                        size_t x = chunkX * chunkSize + localX, y = chunkY * chunkSize + localY;
+                        uint16_t type = (x < width && y < height) ? cells[y * width + x] : noTile16;
+                        if (type >= tileTypes.size()) type = noTile; // unknown types are stored as missing tiles
+                        else if (tileTypes[type].walkable) walkableRows[localY] |= uint32_t(1) << localX;
+
+                        size_t cell = localY * chunkSize + localX;
+                        if (header.cellBytes == 1) cellBytes[cell] = static_cast<uint8_t>(type);
+                        else std::memcpy(cellBytes + cell * 2, &type, 2);
+                    }
+                }
+                OpenBlocks openBlocks = computeOpenBlocks(walkableRows);
+                std::memcpy(record.data() + chunkSize * chunkSize * header.cellBytes, walkableRows, sizeof(walkableRows));
+                std::memcpy(record.data() + chunkSize * chunkSize * header.cellBytes + sizeof(walkableRows), &openBlocks, sizeof(openBlocks));
+                fileStream.write(reinterpret_cast<const char*>(record.data()), record.size());
+            }
+        }
+
+        if (!fileStream) throw std::runtime_error("Failed writing " + filePath.string());
+    }
+
+    MappedFile::MappedFile(const std::filesystem::path& filePath) {
+        int fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+        if (fileDescriptor < 0) throw std::runtime_error("Unable to open file: " + filePath.string());
+
+        struct stat fileStat {};
+        if (::fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size <= 0) {
+            ::close(fileDescriptor);
+            throw std::runtime_error("Unable to read the size of " + filePath.string());
+        }
+        size = static_cast<uint64_t>(fileStat.st_size);
+
+        // private writable mapping: edits copy the touched page instead of changing the file
+        void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+        ::close(fileDescriptor);
+        if (mapping == MAP_FAILED) throw std::runtime_error("Unable to map " + filePath.string());
+        data = static_cast<uint8_t*>(mapping);
+    }
+
+    MappedFile::~MappedFile() {
+        if (data) ::munmap(data, size);
+    }
+}
@@ -0,0 +1,99 @@
+//
+//  tilemapfile.hpp
+//
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/* binary tile map format (.rcmap), little endian:
+    Header              fixed size, see below
+    TileTypeRecord[]    tileTypeCount entries at typeTableOffset
+    chunk records       at cellsOffset, chunksX * chunksY records in row-major chunk order. a record is the chunk's
+                        chunkSize * chunkSize cells (row major, cellBytes each) followed by chunkSize uint32 walkable rows
+                        (bit x of row y set if the cell is walkable) and the chunk's open block masks (OpenBlocks).
+                        cells past the map edge hold noTile
+chunk records are laid out the way TileMap keeps them in memory, so a mapped file is used in place without copying */
+namespace tilemapfile {
+    inline constexpr char magic[8] = { 'R', 'C', 'M', 'A', 'P', '\0', '\0', '\0' };
+    inline constexpr uint32_t version = 2; // 2 added the open block masks
+    inline constexpr uint32_t endianCheck = 0x01020304;
+    inline constexpr uint32_t chunkSize = 32; // must match TileMap::chunkSize
+    inline constexpr uint16_t noTile8 = 0xFF;
+    inline constexpr uint16_t noTile16 = 0xFFFF;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t endianCheck;
+        uint32_t headerSize;
+        uint32_t width; // in tiles
+        uint32_t height;
+        uint32_t chunkSize;
+        uint16_t cellBytes; // 1 or 2
+        uint16_t tileTypeCount;
+        uint32_t reserved;
+        uint64_t typeTableOffset;
+        uint64_t cellsOffset; // 64 byte aligned
+        uint64_t chunkRecordSize;
+    };
+    static_assert(sizeof(Header) == 64, "header layout is part of the file format");
+
+    struct TileTypeRecord {
+        int32_t left, top, width, height; // atlas rect
+        uint8_t walkable;
+        uint8_t padding[3];
+    };
+    static_assert(sizeof(TileTypeRecord) == 20, "type record layout is part of the file format");
+
+    // occupancy pyramid of a chunk: a set bit marks a block whose cells are all walkable
+    struct OpenBlocks {
+        uint64_t blocks4; // 8x8 blocks of 4x4 cells, bit (by * 8 + bx)
+        uint8_t blocks16; // 2x2 blocks of 16x16 cells, bit (by * 2 + bx); all four set means the whole chunk is open
+        uint8_t padding[7];
+    };
+    static_assert(sizeof(OpenBlocks) == 16, "open block layout is part of the file format");
+
+    constexpr uint64_t chunkRecordSize(uint16_t cellBytes) { return uint64_t(chunkSize) * chunkSize * cellBytes + chunkSize * sizeof(uint32_t) + sizeof(OpenBlocks); }
+
+    OpenBlocks computeOpenBlocks(const uint32_t* walkableRows); // from chunkSize walkable rows
+    void updateOpenBlocks(OpenBlocks& blocks, const uint32_t* walkableRows, size_t localX, size_t localY); // only the blocks holding one cell
+
+    // a chunk record with one byte cells, as it sits in the file and in memory
+    struct ChunkRecord {
+        uint8_t tiles[chunkSize * chunkSize]; // row major inside the chunk
+        uint32_t walkableRows[chunkSize]; // bit x of row y set if the cell is walkable
+        OpenBlocks openBlocks;
+    };
+    static_assert(sizeof(ChunkRecord) == chunkRecordSize(1), "chunk record layout is part of the file format");
+
+    bool isBinaryTileMap(const std::filesystem::path& filePath); // true if the file starts with the magic
+    std::string validateHeader(const Header& header, uint64_t fileSize); // empty if the header describes a usable file
+
+    // reads the text format (whitespace separated type indices, one row per line); width is the longest row
+    std::vector<uint16_t> readTextTileMap(const std::filesystem::path& filePath, size_t& width, size_t& height);
+
+    // writes cells (row major, width * height) as a binary map; cellBytes is 1 unless a type needs 2 bytes. throws on failure
+    void writeBinaryTileMap(const std::filesystem::path& filePath, size_t width, size_t height, const std::vector<uint16_t>& cells, const std::vector<TileTypeRecord>& tileTypes);
+
+    // read-only-to-disk mapping of a whole file: pages are copy-on-write, so writes stay private to the process
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::filesystem::path& filePath); // throws if the file can't be mapped
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        uint8_t* getData() const { return data; }
+        uint64_t getSize() const { return size; }
+
+    private:
+        uint8_t* data = nullptr;
+        uint64_t size = 0;
+    };
+}
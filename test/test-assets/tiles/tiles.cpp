@@ -45,88 +45,422 @@ Tile::Tile(const Tile& other)
     }
 }
  
+std::atomic<uint64_t> TileMap::nextMapId { 1 };
+
+TileMap::~TileMap() = default; // out of line so ChunkStreamer's thread stops before the chunks go away
+
 TileMap::TileMap(std::shared_ptr<Tile>* tileTypesArray, unsigned int tileTypesNumber, size_t tileMapWidth, size_t tileMapHeight, float tileWidth, float tileHeight, std::filesystem::path filePath, sf::Vector2f tileMapPosition) 
     : tileTypesNumber(tileTypesNumber), tileMapWidth(tileMapWidth), tileMapHeight(tileMapHeight), tileWidth(tileWidth), tileHeight(tileHeight), tileMapPosition(tileMapPosition) {
 
     try{
-        tiles.reserve( tileMapWidth * tileMapHeight ); 
-
-        std::ifstream fileStream(filePath);
-        
-        if (!fileStream.is_open()) {
-            throw std::runtime_error("Unable to open file: " + filePath.string());
+        if (tileTypesNumber >= noTile) {
+            throw std::out_of_range("Too many tile types for a byte grid: " + std::to_string(tileTypesNumber));
         }
 
-        std::string line;
-        unsigned int currentY = 0; // Track the current row
-
-        while (std::getline(fileStream, line) && currentY < tileMapHeight) {
-            std::istringstream lineStream(line);
-            std::string tileIndexStr;
-            unsigned int currentX = 0; // Track the current column
-
-            while (lineStream >> tileIndexStr && currentX < tileMapWidth) {
-                unsigned int tileIndex = std::stoul(tileIndexStr); // Convert to unsigned int
-                
-                if (tileIndex < tileTypesNumber) {
-                    auto tile = tileTypesArray[tileIndex]->clone();
-                    tile->getTileSprite().setPosition(tileMapPosition.x + currentX * tileWidth, tileMapPosition.y + currentY * tileHeight); 
-                    tiles.emplace_back(std::move(tile));
-                    
-                } else {
-                    throw std::out_of_range("Tile index out of bounds: " + std::to_string(tileIndex));
-                }
-                currentX++; // Increment column index
-            } 
-            currentY++; // Increment row index
+        tileTypes.assign(tileTypesArray, tileTypesArray + tileTypesNumber);
+        tileTypeInfo.reserve(tileTypesNumber);
+        for (const auto& tileType : tileTypes) {
+            if (!tileType) throw std::runtime_error("Missing tile type template");
+            sf::IntRect rect = tileType->getTextureRect();
+            sf::Vector2f scale = tileType->getTileSprite().getScale();
+            tileTypeInfo.push_back({ rect, sf::Vector2f(rect.width * scale.x, rect.height * scale.y), tileType->getWalkable() });
         }
+        if (!tileTypes.empty()) texture = tileTypes.front()->getTexture();
 
-        fileStream.close();
-
-        log_info("Tile map initialized successfully");
+        if (tilemapfile::isBinaryTileMap(filePath)) loadBinary(filePath);
+        else loadText(filePath);
     } catch (const std::exception& e) {
         log_warning("Error in making tilemap: " + std::string(e.what()));
     }
 }
 
+void TileMap::loadText(const std::filesystem::path& filePath) {
+    // every cell starts as a wall with no tile, so a short map file leaves solid cells behind
+    chunksX = (tileMapWidth + chunkMask) >> chunkShift;
+    chunksY = (tileMapHeight + chunkMask) >> chunkShift;
+    chunks.resize(chunksX * chunksY);
+    for (auto& chunk : chunks) allocateChunkCells(chunk);
+
+    std::ifstream fileStream(filePath);
+    
+    if (!fileStream.is_open()) {
+        throw std::runtime_error("Unable to open file: " + filePath.string());
+    }
+
+    std::string line;
+    unsigned int currentY = 0; // Track the current row
+
+    while (std::getline(fileStream, line) && currentY < tileMapHeight) {
+        std::istringstream lineStream(line);
+        std::string tileIndexStr;
+        unsigned int currentX = 0; // Track the current column
+
+        while (lineStream >> tileIndexStr && currentX < tileMapWidth) {
+            unsigned int tileIndex = std::stoul(tileIndexStr); // Convert to unsigned int
+            
+            if (tileIndex < tileTypesNumber) {
+                ChunkCells& cells = *chunks[(currentY >> chunkShift) * chunksX + (currentX >> chunkShift)].cells;
+                setChunkCell(cells, currentX & chunkMask, currentY & chunkMask, static_cast<uint8_t>(tileIndex));
+            } else {
+                throw std::out_of_range("Tile index out of bounds: " + std::to_string(tileIndex));
+            }
+            currentX++; // Increment column index
+        } 
+        currentY++; // Increment row index
+    }
+
+    fileStream.close();
+    for (TileChunk& chunk : chunks) chunk.cells->openBlocks = tilemapfile::computeOpenBlocks(chunk.cells->walkableRows);
+
+    log_info("Tile map initialized successfully (" + std::to_string(chunksX) + "x" + std::to_string(chunksY) + " chunks of " + std::to_string(chunkSize) + " tiles)");
+}
+
+void TileMap::loadBinary(const std::filesystem::path& filePath) {
+    mappedFile = std::make_unique<tilemapfile::MappedFile>(filePath);
+    if (mappedFile->getSize() < sizeof(tilemapfile::Header)) {
+        throw std::runtime_error("Binary tile map is smaller than its header: " + filePath.string());
+    }
+
+    tilemapfile::Header header;
+    std::memcpy(&header, mappedFile->getData(), sizeof(header));
+    std::string error = tilemapfile::validateHeader(header, mappedFile->getSize());
+    if (!error.empty()) throw std::runtime_error("Invalid binary tile map " + filePath.string() + ": " + error);
+    if (header.cellBytes != 1) throw std::runtime_error("Binary tile map uses two byte cells, the tile map holds one byte types: " + filePath.string());
+
+    if (header.width != tileMapWidth || header.height != tileMapHeight) {
+        log_warning("Binary tile map is " + std::to_string(header.width) + "x" + std::to_string(header.height) + ", using that instead of the configured size");
+        tileMapWidth = header.width;
+        tileMapHeight = header.height;
+    }
+
+    chunksX = (tileMapWidth + chunkMask) >> chunkShift;
+    chunksY = (tileMapHeight + chunkMask) >> chunkShift;
+    chunks.resize(chunksX * chunksY);
+    uint8_t* records = mappedFile->getData() + header.cellsOffset;
+    for (size_t i = 0; i < chunks.size(); ++i) chunks[i].cells = reinterpret_cast<ChunkCells*>(records + i * header.chunkRecordSize);
+
+    // the walkable bits were baked with the file's type table; only if it disagrees with ours do the cells get touched
+    const auto* fileTypes = reinterpret_cast<const tilemapfile::TileTypeRecord*>(mappedFile->getData() + header.typeTableOffset);
+    bool walkableMatches = header.tileTypeCount == tileTypesNumber;
+    for (size_t type = 0; walkableMatches && type < tileTypesNumber; ++type) {
+        walkableMatches = (fileTypes[type].walkable != 0) == tileTypeInfo[type].walkable;
+    }
+    if (!walkableMatches) {
+        log_warning("Binary tile map types differ from the configured tiles, rebuilding walkable bits");
+        rebuildWalkable = true;
+        for (TileChunk& chunk : chunks) rebuildWalkableRows(*chunk.cells);
+    }
+
+    binaryPath = filePath;
+    binaryHeader = header;
+    log_info("Tile map mapped successfully (" + std::to_string(chunksX) + "x" + std::to_string(chunksY) + " chunks of " + std::to_string(chunkSize) + " tiles, " + std::to_string(mappedFile->getSize()) + " bytes)");
+}
+
+void TileMap::rebuildWalkableRows(ChunkCells& cells) {
+    for (size_t cell = 0; cell < chunkCellCount; ++cell) {
+        uint8_t type = cells.tiles[cell];
+        if (type >= tileTypesNumber) type = noTile; // a type we don't have reads as a missing tile
+        setChunkCell(cells, cell & chunkMask, cell >> chunkShift, type);
+    }
+    cells.openBlocks = tilemapfile::computeOpenBlocks(cells.walkableRows);
+}
+
+void TileMap::allocateChunkCells(TileChunk& chunk) {
+    chunk.ownedCells = std::make_unique<ChunkCells>();
+    std::fill(std::begin(chunk.ownedCells->tiles), std::end(chunk.ownedCells->tiles), noTile);
+    std::fill(std::begin(chunk.ownedCells->walkableRows), std::end(chunk.ownedCells->walkableRows), 0u);
+    chunk.ownedCells->openBlocks = tilemapfile::OpenBlocks {};
+    chunk.cells = chunk.ownedCells.get();
+}
+
 void TileMap::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    for (const auto& tile : tiles) {
-        if (tile) {
-            target.draw(tile->getTileSprite(), states);
+    const sf::View& view = target.getView();
+    sf::FloatRect viewRect(view.getCenter() - view.getSize() / 2.0f, view.getSize());
+    sf::IntRect range = getChunksInRect(viewRect);
+
+    if (auto sharedTexture = texture.lock()) states.texture = sharedTexture.get();
+    for (int chunkY = range.top; chunkY < range.top + range.height; ++chunkY) {
+        for (int chunkX = range.left; chunkX < range.left + range.width; ++chunkX) {
+            const TileChunk& chunk = chunks[chunkY * chunksX + chunkX];
+            if (!chunk.cells) continue;
+
+            updateChunkVertices(chunk, chunkX, chunkY);
+            target.draw(chunk.vertices, states);
         }
     }
 }
 
-// Add a tile to the map at the specified grid position (x, y)
-void TileMap::addTile(unsigned int x, unsigned int y, std::unique_ptr<Tile> tile) {
+sf::IntRect TileMap::getChunksInRect(const sf::FloatRect& worldRect) const {
+    float chunkWidth = tileWidth * chunkSize, chunkHeight = tileHeight * chunkSize;
+    float left = std::floor((worldRect.left - tileMapPosition.x) / chunkWidth);
+    float top = std::floor((worldRect.top - tileMapPosition.y) / chunkHeight);
+    float right = std::floor((worldRect.left + worldRect.width - tileMapPosition.x) / chunkWidth) + 1.0f;
+    float bottom = std::floor((worldRect.top + worldRect.height - tileMapPosition.y) / chunkHeight) + 1.0f;
+
+    int firstX = static_cast<int>(std::clamp(left, 0.0f, static_cast<float>(chunksX)));
+    int firstY = static_cast<int>(std::clamp(top, 0.0f, static_cast<float>(chunksY)));
+    int lastX = static_cast<int>(std::clamp(right, 0.0f, static_cast<float>(chunksX)));
+    int lastY = static_cast<int>(std::clamp(bottom, 0.0f, static_cast<float>(chunksY)));
+    return sf::IntRect(firstX, firstY, lastX - firstX, lastY - firstY);
+}
+
+void TileMap::writeQuad(const TileChunk& chunk, size_t chunkX, size_t chunkY, size_t cell, sf::Vertex* quad) const {
+    uint8_t type = chunk.cells->tiles[cell];
+    if (type >= tileTypeInfo.size()) { // missing tile, degenerate quad, nothing is drawn
+        for (int i = 0; i < 4; ++i) quad[i] = sf::Vertex();
+        return;
+    }
+
+    const TileTypeInfo& info = tileTypeInfo[type];
+    size_t x = (chunkX << chunkShift) + (cell & chunkMask), y = (chunkY << chunkShift) + (cell >> chunkShift);
+    sf::Vector2f topLeft = tileMapPosition + sf::Vector2f(x * tileWidth, y * tileHeight);
+    float left = static_cast<float>(info.textureRect.left), top = static_cast<float>(info.textureRect.top);
+    float right = left + info.textureRect.width, bottom = top + info.textureRect.height;
+
+    quad[0] = sf::Vertex(topLeft, sf::Vector2f(left, top));
+    quad[1] = sf::Vertex(topLeft + sf::Vector2f(info.quadSize.x, 0.0f), sf::Vector2f(right, top));
+    quad[2] = sf::Vertex(topLeft + info.quadSize, sf::Vector2f(right, bottom));
+    quad[3] = sf::Vertex(topLeft + sf::Vector2f(0.0f, info.quadSize.y), sf::Vector2f(left, bottom));
+}
+
+void TileMap::updateChunkVertices(const TileChunk& chunk, size_t chunkX, size_t chunkY) const {
+    if (!chunk.verticesBuilt) {
+        if (isStreaming()) residentVertexBytes += chunkCellCount * 4 * sizeof(sf::Vertex);
+        chunk.vertices.resize(chunkCellCount * 4);
+        for (size_t cell = 0; cell < chunkCellCount; ++cell) writeQuad(chunk, chunkX, chunkY, cell, &chunk.vertices[cell * 4]);
+        chunk.verticesBuilt = true;
+        chunk.dirtyCells.clear();
+        return;
+    }
+
+    for (uint16_t cell : chunk.dirtyCells) writeQuad(chunk, chunkX, chunkY, cell, &chunk.vertices[cell * 4]);
+    chunk.dirtyCells.clear();
+}
+
+// Set the tile type at the specified grid position (x, y)
+void TileMap::setTile(unsigned int x, unsigned int y, uint8_t tileType) {
     try{
         if (x >= tileMapWidth || y >= tileMapHeight) {
             throw std::out_of_range("Tile position out of bounds: (" + std::to_string(x) + ", " + std::to_string(y) + ")");
         }
-
-        // Calculate the index in the tiles vector
-        unsigned int index = y * tileMapWidth + x;
-
-        // Ensure the tile is valid (not nullptr)
-        if (!tile) {
-            throw std::runtime_error("Attempted to add a null tile.");
+        if (tileType >= tileTypesNumber) {
+            throw std::out_of_range("Tile type out of bounds: " + std::to_string(tileType));
         }
 
-        // Move the tile into the tiles vector at the calculated index
-        tiles[index] = std::move(tile);
-
-        // Optionally set the position of the tile if the Tile class has a method for that
-        tiles[index]->getTileSprite().setPosition(tileMapPosition.x + x * tileWidth, tileMapPosition.y + y * tileHeight);
+        TileChunk& chunk = chunks[(y >> chunkShift) * chunksX + (x >> chunkShift)];
+        if (isStreaming()) {
+            if (!chunk.cells) throw std::runtime_error("Tile (" + std::to_string(x) + ", " + std::to_string(y) + ") is in a chunk that isn't streamed in");
+            chunk.modified = true;
+        }
+        if (!chunk.cells) allocateChunkCells(chunk);
+        bool wasWalkable = isWalkable(x, y);
+        setChunkCell(*chunk.cells, x & chunkMask, y & chunkMask, tileType);
+        tilemapfile::updateOpenBlocks(chunk.cells->openBlocks, chunk.cells->walkableRows, x & chunkMask, y & chunkMask);
+        if (isWalkable(x, y) != wasWalkable) logWalkableChange(sf::IntRect(x, y, 1, 1));
+        ++contentVersion;
+        if (chunk.verticesBuilt) chunk.dirtyCells.push_back(static_cast<uint16_t>(((y & chunkMask) << chunkShift) | (x & chunkMask)));
     } catch (const std::exception& e) {
         log_error(e.what()); // Log any exceptions that occur
     }
 }
 
-std::unique_ptr<Tile>& TileMap::getTile(size_t index) {
-    if (index < tiles.size()) {
-        return tiles[index]; // Return the tile at the specified index
+void TileMap::setChunkCell(ChunkCells& cells, size_t localX, size_t localY, uint8_t tileType) {
+    cells.tiles[(localY << chunkShift) | localX] = tileType;
+    uint32_t bit = uint32_t(1) << localX;
+    uint32_t& row = cells.walkableRows[localY];
+    bool walkable = tileType < tileTypeInfo.size() && tileTypeInfo[tileType].walkable;
+    row = walkable ? (row | bit) : (row & ~bit);
+}
+
+void TileMap::setTileTypeWalkable(uint8_t tileType, bool walkable) {
+    if (tileType >= tileTypesNumber || tileTypeInfo[tileType].walkable == walkable) return;
+
+    tileTypeInfo[tileType].walkable = walkable;
+    tileTypes[tileType]->setWalkable(walkable);
+    rebuildWalkable = true; // chunks streamed in later get the new bits too
+
+    for (TileChunk& chunk : chunks) {
+        if (!chunk.cells) continue;
+        if (std::find(std::begin(chunk.cells->tiles), std::end(chunk.cells->tiles), tileType) == std::end(chunk.cells->tiles)) continue;
+        rebuildWalkableRows(*chunk.cells);
+    }
+    clearWalkableLog();
+}
+
+bool TileMap::getWalkableChangesSince(uint64_t version, std::vector<sf::IntRect>& regions) const {
+    uint64_t oldest = walkableVersion - walkableChanges.size(); // version the log starts after
+    if (version < oldest || version > walkableVersion) return false;
+    regions.insert(regions.end(), walkableChanges.begin() + (version - oldest), walkableChanges.end());
+    return true;
+}
+
+void TileMap::logWalkableChange(const sf::IntRect& cells) {
+    walkableChanges.push_back(cells);
+    if (walkableChanges.size() > walkableLogLimit) walkableChanges.pop_front();
+    ++walkableVersion;
+    ++contentVersion;
+}
+
+void TileMap::clearWalkableLog() {
+    walkableChanges.clear();
+    ++walkableVersion;
+    ++contentVersion;
+}
+
+sf::IntRect TileMap::getChunkCellRect(size_t chunkIndex) const {
+    size_t left = (chunkIndex % chunksX) << chunkShift, top = (chunkIndex / chunksX) << chunkShift;
+    return sf::IntRect(static_cast<int>(left), static_cast<int>(top), static_cast<int>(std::min(chunkSize, tileMapWidth - left)), static_cast<int>(std::min(chunkSize, tileMapHeight - top)));
+}
+
+uint8_t TileMap::getTileType(size_t index) const {
+    size_t x = index % tileMapWidth, y = index / tileMapWidth;
+    if (y >= tileMapHeight) return noTile;
+    const ChunkCells* cells = chunks[(y >> chunkShift) * chunksX + (x >> chunkShift)].cells;
+    return cells ? cells->tiles[((y & chunkMask) << chunkShift) | (x & chunkMask)] : noTile;
+}
+
+const std::shared_ptr<Tile>& TileMap::getTile(size_t index) const {
+    uint8_t type = getTileType(index);
+    if (type < tileTypes.size()) {
+        return tileTypes[type]; // Return the type template of the tile at the specified index
     } else {
-        // Handle the case where the index is out of bounds, throw an exception or return a nullptr
+        // Handle the case where the index is out of bounds or the cell is empty
         throw std::out_of_range("Index is out of range in getTile");
     }
-}
\ No newline at end of file
+}
+
+sf::IntRect TileMap::getTileTextureRect(size_t index) const {
+    uint8_t type = getTileType(index);
+    return type < tileTypeInfo.size() ? tileTypeInfo[type].textureRect : sf::IntRect();
+}
+
+bool TileMap::enableStreaming(size_t budgetBytes, size_t pinRadius) {
+    try {
+        if (!mappedFile) throw std::runtime_error("only binary tile maps can be streamed");
+
+        streamer = std::make_unique<ChunkStreamer>(binaryPath, binaryHeader.cellsOffset, binaryHeader.chunkRecordSize, chunks.size());
+        streamingBudgetBytes = budgetBytes;
+        this->pinRadius = pinRadius;
+
+        // everything starts out missing; the mapping goes away so only streamed chunks take memory
+        for (TileChunk& chunk : chunks) {
+            chunk.cells = nullptr;
+            chunk.ownedCells.reset();
+            chunk.vertices = sf::VertexArray(sf::Quads);
+            chunk.dirtyCells.clear();
+            chunk.verticesBuilt = false;
+        }
+        mappedFile.reset();
+        clearWalkableLog();
+
+        log_info("Tile map streaming enabled (" + std::to_string(budgetBytes / (1024 * 1024)) + " MB budget, pin radius " + std::to_string(pinRadius) + ")");
+        return true;
+    } catch (const std::exception& e) {
+        log_warning("Tile map streaming not enabled: " + std::string(e.what()));
+        return false;
+    }
+}
+
+sf::Vector2i TileMap::getChunkAt(sf::Vector2f position) const {
+    return sf::Vector2i(static_cast<int>(std::floor((position.x - tileMapPosition.x) / (tileWidth * chunkSize))),
+                        static_cast<int>(std::floor((position.y - tileMapPosition.y) / (tileHeight * chunkSize))));
+}
+
+void TileMap::installStreamedChunk(size_t chunkIndex, std::unique_ptr<ChunkCells> cells) {
+    TileChunk& chunk = chunks[chunkIndex];
+    if (chunk.cells || !cells) return; // loaded twice, or already there
+
+    if (rebuildWalkable) rebuildWalkableRows(*cells);
+    chunk.ownedCells = std::move(cells);
+    chunk.cells = chunk.ownedCells.get();
+    residentChunks.push_front(chunkIndex);
+    chunk.residentPosition = residentChunks.begin();
+    logWalkableChange(getChunkCellRect(chunkIndex));
+}
+
+void TileMap::prefetch(sf::Vector2f position) {
+    if (!isStreaming()) return;
+
+    sf::Vector2i center = getChunkAt(position);
+    long radius = static_cast<long>(pinRadius);
+    for (long chunkY = center.y - radius; chunkY <= center.y + radius; ++chunkY) {
+        for (long chunkX = center.x - radius; chunkX <= center.x + radius; ++chunkX) {
+            if (chunkX < 0 || chunkY < 0 || chunkX >= static_cast<long>(chunksX) || chunkY >= static_cast<long>(chunksY)) continue;
+            size_t chunkIndex = chunkY * chunksX + chunkX;
+            if (!chunks[chunkIndex].cells) installStreamedChunk(chunkIndex, streamer->loadNow(chunkIndex));
+        }
+    }
+}
+
+void TileMap::updateStreaming(sf::Vector2f position, sf::Vector2f heading, float range) {
+    if (!isStreaming()) return;
+
+    // chunks the I/O thread finished since last frame
+    streamedChunks.clear();
+    streamer->takeLoaded(streamedChunks);
+    for (auto& loaded : streamedChunks) installStreamedChunk(loaded.index, std::move(loaded.cells));
+
+    // every chunk a ray could reach: resident ones count as used, missing ones are requested, ahead of the player first
+    sf::Vector2f chunkPixels(tileWidth * chunkSize, tileHeight * chunkSize);
+    sf::Vector2i center = getChunkAt(position);
+    sf::Vector2f local((position.x - tileMapPosition.x) / chunkPixels.x, (position.y - tileMapPosition.y) / chunkPixels.y); // in chunks
+    float headingLength = std::sqrt(heading.x * heading.x + heading.y * heading.y);
+    sf::Vector2f direction = headingLength > 0.0f ? heading / headingLength : sf::Vector2f();
+    long radius = std::max(static_cast<long>(pinRadius), static_cast<long>(std::ceil(range / std::min(chunkPixels.x, chunkPixels.y))) + 1);
+
+    streamingCandidates.clear();
+    for (long chunkY = center.y - radius; chunkY <= center.y + radius; ++chunkY) {
+        for (long chunkX = center.x - radius; chunkX <= center.x + radius; ++chunkX) {
+            if (chunkX < 0 || chunkY < 0 || chunkX >= static_cast<long>(chunksX) || chunkY >= static_cast<long>(chunksY)) continue;
+
+            float offsetX = chunkX + 0.5f - local.x, offsetY = chunkY + 0.5f - local.y;
+            float distance = std::sqrt(offsetX * offsetX + offsetY * offsetY);
+            bool pinned = std::abs(chunkX - center.x) <= static_cast<long>(pinRadius) && std::abs(chunkY - center.y) <= static_cast<long>(pinRadius);
+            if (!pinned && distance > radius + 0.5f) continue;
+
+            size_t chunkIndex = chunkY * chunksX + chunkX;
+            TileChunk& chunk = chunks[chunkIndex];
+            if (chunk.cells) {
+                if (chunk.ownedCells) residentChunks.splice(residentChunks.begin(), residentChunks, chunk.residentPosition);
+                continue;
+            }
+
+            // chunks ahead cost half their distance, chunks behind one and a half times it
+            float facing = distance > 0.0f ? (offsetX * direction.x + offsetY * direction.y) / distance : 1.0f;
+            float priority = pinned ? -1.0f : distance * (1.0f - 0.5f * facing);
+            streamingCandidates.push_back({ priority, chunkIndex });
+        }
+    }
+
+    std::sort(streamingCandidates.begin(), streamingCandidates.end());
+    streamingRequests.clear();
+    for (const auto& candidate : streamingCandidates) streamingRequests.push_back(candidate.second);
+    streamer->setRequests(streamingRequests); // it skips chunks it is already reading or failed to read
+
+    evictStreamedChunks(center.x, center.y);
+}
+
+void TileMap::evictStreamedChunks(long playerChunkX, long playerChunkY) {
+    // oldest first; pinned and edited chunks go back to the front so the walk ends after one lap
+    size_t checked = 0, residentCount = residentChunks.size();
+    while (getResidentBytes() > streamingBudgetBytes && checked++ < residentCount) {
+        size_t chunkIndex = residentChunks.back();
+        TileChunk& chunk = chunks[chunkIndex];
+        long chunkX = static_cast<long>(chunkIndex % chunksX), chunkY = static_cast<long>(chunkIndex / chunksX);
+        bool pinned = std::abs(chunkX - playerChunkX) <= static_cast<long>(pinRadius) && std::abs(chunkY - playerChunkY) <= static_cast<long>(pinRadius);
+
+        if (pinned || chunk.modified) {
+            residentChunks.splice(residentChunks.begin(), residentChunks, chunk.residentPosition);
+            continue;
+        }
+
+        if (chunk.verticesBuilt) residentVertexBytes -= chunkCellCount * 4 * sizeof(sf::Vertex);
+        chunk.vertices = sf::VertexArray(sf::Quads);
+        chunk.dirtyCells.clear();
+        chunk.verticesBuilt = false;
+        chunk.cells = nullptr;
+        chunk.ownedCells.reset();
+        residentChunks.pop_back();
+        logWalkableChange(getChunkCellRect(chunkIndex));
+    }
+}
@@ -11,8 +11,18 @@
 #include <SFML/Graphics.hpp>
 #include <fstream>
 #include <sstream>
+#include <cstdint>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <deque>
+#include <atomic>
 
 #include "../../test-logging/log.hpp"
+#include "tilemapfile.hpp"
+#include "chunkstreamer.hpp"
+#include <list>
 
 
 class Tile {
@@ -23,10 +33,10 @@ public:
     sf::Sprite& getTileSprite() const { return *tileSprite; } 
 
     sf::IntRect const getTextureRect() const { return textureRect; }
+    std::weak_ptr<sf::Texture> const getTexture() const { return texture; }
     std::weak_ptr<sf::Uint8[]>  const getBitMask() const { return bitmask; }
  
-    bool getWalkable() const { return walkable; }
-    void setWalkable(bool newWalkable) { walkable = newWalkable; }
+    bool getWalkable() const { return walkable; } // changed only through TileMap::setTileTypeWalkable
     
     // making copies for use in tilemap
     virtual std::unique_ptr<Tile> clone() const {
@@ -36,6 +46,10 @@ public:
     Tile(const Tile& other); 
 
 private:
+    // the chunks' walkable bits and the raycaster's data are derived from this, so only TileMap may change it
+    friend class TileMap;
+    void setWalkable(bool newWalkable) { walkable = newWalkable; }
+
     sf::Vector2f position {};
     std::unique_ptr<sf::Sprite> tileSprite {};
     sf::Vector2f scale {};
@@ -45,14 +59,29 @@ private:
     bool walkable {};
 };
 
+/* the map is split into chunkSize x chunkSize chunks. every chunk stores one byte of tile type per cell, a walkable bit
+per cell (one 32-bit word per row) and its own batched vertex array; per-type properties (texture rect, walkability,
+sprite, bitmask) are held once in the tile type table.
+only chunks intersecting the target's view are drawn; a chunk's quads are built on its first draw and setTile only queues
+the cell, queued quads are rewritten on the chunk's next draw. a missing chunk reads as solid wall with no tiles.
+the file can be the text format or the binary format from tilemapfile.hpp; a binary file is mapped and its chunk records
+are used in place, so loading only validates the header.
+with streaming on (binary maps only) chunks start out missing and are read around the player on a background thread:
+updateStreaming installs finished chunks, re-prioritizes the rest by distance and heading and drops least recently
+used chunks past the memory budget, never waiting on the disk. the raycaster keeps seeing missing chunks as walls */
 class TileMap : public sf::Drawable {
 public:
-    // Constructor now accepts a shared_ptr to a default tile, and initializes the map with it
+    static constexpr uint8_t noTile = 0xFF; // cells the map file didn't fill; they count as walls and have no texture
+    static constexpr size_t chunkShift = 5;
+    static constexpr size_t chunkSize = size_t(1) << chunkShift; // chunk edge in tiles
+    static constexpr size_t chunkMask = chunkSize - 1;
+
+    // Constructor now accepts a shared_ptr to a default tile, and initializes the map with it. a binary file's own size wins over the given one
     explicit TileMap(std::shared_ptr<Tile>* tileTypesArray, unsigned int tileTypesNumber, size_t tileMapWidth, size_t tileMapHeight, float tileWidth, float tileHeight, std::filesystem::path filePath, sf::Vector2f tileMapPosition);
-    ~TileMap() = default;
+    ~TileMap();
     
-    // Add a tile to the map at the specified grid position (x, y)
-    void addTile(unsigned int x, unsigned int y, std::unique_ptr<Tile> tile); 
+    // Set the tile type at the specified grid position (x, y)
+    void setTile(unsigned int x, unsigned int y, uint8_t tileType); 
     float const getTileWidth() const { return tileWidth; }
     float const getTileHeight() const { return tileHeight; }
     size_t const getTileMapWidth() const { return tileMapWidth; }
@@ -61,9 +90,77 @@ public:
     unsigned int const getTileTypesNumber() const { return tileTypesNumber; }
     bool const getVisibleState() const { return visibleState; }
     void setVisibleState(bool newVisibleState) { visibleState = newVisibleState; }
-    std::unique_ptr<Tile>& getTile(size_t index);
+    const std::shared_ptr<Tile>& getTile(size_t index) const; // tile type template of the cell at index
+    uint8_t getTileType(size_t index) const;
+
+    // unchecked-by-exception lookup for the raycaster; missing tiles and chunks count as walls
+    bool isWalkable(size_t x, size_t y) const {
+        if (x >= tileMapWidth || y >= tileMapHeight) return false;
+        const ChunkCells* cells = chunks[(y >> chunkShift) * chunksX + (x >> chunkShift)].cells;
+        return cells && ((cells->walkableRows[y & chunkMask] >> (x & chunkMask)) & 1u);
+    }
+    sf::IntRect getTileTextureRect(size_t index) const; // atlas rect of the tile at index, empty if there is none
+
+    /* log2 of the edge of the largest all-walkable block holding the cell: 5 for a whole open chunk, 4 for an open 16x16
+    block, 2 for an open 4x4 block, 0 otherwise (including walls and missing chunks). blocks are aligned to their size */
+    unsigned int getOpenBlockShift(size_t x, size_t y) const {
+        if (x >= tileMapWidth || y >= tileMapHeight) return 0;
+        const ChunkCells* cells = chunks[(y >> chunkShift) * chunksX + (x >> chunkShift)].cells;
+        if (!cells) return 0;
+        size_t localX = x & chunkMask, localY = y & chunkMask;
+        uint8_t blocks16 = cells->openBlocks.blocks16;
+        if (blocks16 == 0xF) return 5;
+        if ((blocks16 >> ((localY >> 4) * 2 + (localX >> 4))) & 1u) return 4;
+        if ((cells->openBlocks.blocks4 >> ((localY >> 2) * 8 + (localX >> 2))) & 1u) return 2;
+        return 0;
+    }
+
+    // changes whether every tile of a type is walkable (the type's Tile template too) and refreshes the loaded chunks
+    void setTileTypeWalkable(uint8_t tileType, bool walkable);
+
+    /* walkability changes (setTile, chunks streamed in or out) are logged as cell rects so data derived from the map can
+    refresh just the changed area. getWalkableChangesSince appends the rects logged after a version and returns false
+    when the log doesn't reach back that far anymore, then the caller has to rebuild everything. the map id tells maps
+    apart for callers that keep such data across maps */
+    uint64_t getMapId() const { return mapId; }
+    uint64_t getWalkableVersion() const { return walkableVersion; }
+    bool getWalkableChangesSince(uint64_t version, std::vector<sf::IntRect>& regions) const;
+    uint64_t getContentVersion() const { return contentVersion; } // bumped by every change to the cells, walkable or not
+
+    size_t getChunksX() const { return chunksX; }
+    size_t getChunksY() const { return chunksY; }
+    sf::IntRect getChunksInRect(const sf::FloatRect& worldRect) const; // chunk coordinates overlapping a world rect, clamped to the map
+
+    // switches a binary map to streaming; pinRadius is in chunks around the player's chunk. false if the map isn't binary
+    bool enableStreaming(size_t budgetBytes, size_t pinRadius);
+    void updateStreaming(sf::Vector2f position, sf::Vector2f heading, float range); // once per frame, before anything reads the map
+    void prefetch(sf::Vector2f position); // blocking load of the pinned chunks, for startup and teleports
+    bool isStreaming() const { return streamer != nullptr; }
+    size_t getResidentChunkCount() const { return residentChunks.size(); }
+    size_t getResidentBytes() const { return residentChunks.size() * sizeof(ChunkCells) + residentVertexBytes; }
 
 private:
+    struct TileTypeInfo {
+        sf::IntRect textureRect {};
+        sf::Vector2f quadSize {}; // texture rect times the sprite scale, what the old per-tile sprite covered
+        bool walkable {};
+    };
+
+    using ChunkCells = tilemapfile::ChunkRecord; // same layout as a binary file's chunk record, so mapped records are used in place
+    static constexpr size_t chunkCellCount = chunkSize * chunkSize;
+    static_assert(chunkSize <= 32 && chunkSize == tilemapfile::chunkSize, "walkable rows are the file's 32-bit words");
+    static constexpr size_t walkableLogLimit = 256; // logged changes kept, older versions have to rebuild
+
+    struct TileChunk {
+        ChunkCells* cells = nullptr; // null if the chunk has no data
+        std::unique_ptr<ChunkCells> ownedCells; // backing store when the cells don't live in the mapped file
+        mutable sf::VertexArray vertices { sf::Quads }; // draw-time cache
+        mutable std::vector<uint16_t> dirtyCells; // cells whose quads are stale
+        mutable bool verticesBuilt = false;
+        std::list<size_t>::iterator residentPosition; // place in residentChunks while streamed in
+        bool modified = false; // edited while streaming, never evicted so the edit isn't lost
+    };
+
     unsigned int tileTypesNumber {};
     size_t tileMapWidth{};
     size_t tileMapHeight{}; 
@@ -71,10 +168,51 @@ private:
     float tileWidth {};
     float tileHeight {};
 
-    std::vector<std::unique_ptr<Tile>> tiles; 
+    std::vector<std::shared_ptr<Tile>> tileTypes; // rendering and collision data, one per type
+    std::vector<TileTypeInfo> tileTypeInfo; // hot per-type properties, indexed by tile type
+    std::vector<TileChunk> chunks; // row major, chunksX * chunksY
+    std::unique_ptr<tilemapfile::MappedFile> mappedFile; // set when loaded from a binary map
+    size_t chunksX {};
+    size_t chunksY {};
+
     sf::Vector2f tileMapPosition; 
     bool visibleState = true;
 
-    // Override the draw function of sf::Drawable to draw all tiles
+    std::weak_ptr<sf::Texture> texture; // shared by every tile type
+
+    static std::atomic<uint64_t> nextMapId;
+    uint64_t mapId = nextMapId.fetch_add(1);
+    uint64_t walkableVersion {};
+    uint64_t contentVersion {};
+    std::deque<sf::IntRect> walkableChanges; // the last changes, walkableVersion is the newest
+
+    std::filesystem::path binaryPath;
+    tilemapfile::Header binaryHeader {};
+    bool rebuildWalkable = false; // the file's type table disagrees with ours, recompute walkable bits of loaded chunks
+
+    std::unique_ptr<ChunkStreamer> streamer;
+    std::list<size_t> residentChunks; // streamed chunks, most recently used first
+    mutable size_t residentVertexBytes {}; // built vertex arrays of streamed chunks
+    size_t streamingBudgetBytes {};
+    size_t pinRadius {};
+    std::vector<std::pair<float, size_t>> streamingCandidates; // reused every update
+    std::vector<size_t> streamingRequests;
+    std::vector<ChunkStreamer::LoadedChunk> streamedChunks;
+
+    void loadText(const std::filesystem::path& filePath);
+    void loadBinary(const std::filesystem::path& filePath);
+    void allocateChunkCells(TileChunk& chunk); // empty owned cells: no tiles, nothing walkable
+    void setChunkCell(ChunkCells& cells, size_t localX, size_t localY, uint8_t tileType);
+    void rebuildWalkableRows(ChunkCells& cells);
+    void logWalkableChange(const sf::IntRect& cells);
+    void clearWalkableLog(); // everything changed, versions before now can't catch up
+    void installStreamedChunk(size_t chunkIndex, std::unique_ptr<ChunkCells> cells);
+    void evictStreamedChunks(long playerChunkX, long playerChunkY);
+    sf::Vector2i getChunkAt(sf::Vector2f position) const; // may be outside the map
+    sf::IntRect getChunkCellRect(size_t chunkIndex) const; // the chunk's cells, clipped to the map
+    void writeQuad(const TileChunk& chunk, size_t chunkX, size_t chunkY, size_t cell, sf::Vertex* quad) const;
+    void updateChunkVertices(const TileChunk& chunk, size_t chunkX, size_t chunkY) const; // builds the chunk's quads once, then rewrites only the dirty ones
+
+    // Override the draw function of sf::Drawable to draw the chunks in view
     virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 };
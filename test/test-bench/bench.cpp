@@ -0,0 +1,514 @@
+//
+//  bench.cpp
+//
+//  headless raycaster benchmark: replays scripted camera paths through physics::calculateRayCast3d on tilemap.txt, on
+//  dense random maps made by Constants::writeRandomTileMap and on open maps (1% wall pillars), once per ray traversal
+//  (dda, mipgrid, distance). Then moves tile-sized sprites around in every broadphase (quadtree, loose, hash, sap) and times
+//  update, region queries and the pair list at several sprite counts. Prints a summary and optionally writes it as JSON.
+//
+//  usage: sfml_game_bench [--json file] [--frames n] [--rays n] [--threads n] [--sizes 64,256,...] [--max-tiles n] [--seed n] [--binary [--stream mb]] [--traversal dda|mipgrid|distance] [--no-cache]
+//                         [--entities 100,1000,...] [--broadphase quadtree|loose|hash|sap] [--broadphase-only]
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <numeric>
+#include <random>
+
+#include "../test-src/game/physics/physics.hpp"
+#include "../test-src/game/core/jobs.hpp"
+#include "../test-testing/testing.hpp"
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// allocation counting (every thread, only read around the timed calls)
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    std::atomic<size_t> allocationCount { 0 };
+
+    void* countedAllocate(std::size_t size) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        if (void* memory = std::malloc(size ? size : 1)) return memory;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+    struct BenchOptions {
+        std::filesystem::path jsonPath;
+        size_t frames = 360;
+        size_t rays = 0; // columns per frame, 0 = RAYS_NUM / 2 from config.yaml
+        size_t threads = 0; // 0 = worker_threads from config.yaml
+        std::vector<size_t> sizes { 64, 256, 1024, 4096 };
+        size_t maxTiles = size_t(1) << 24; // bigger maps are reported as skipped
+        unsigned int seed = 1;
+        bool binary = false; // convert every map to the binary format first and load that
+        size_t streamBudgetMb = 0; // with --binary: stream chunks within this budget, updateStreaming is timed with the cast
+        std::vector<std::string> traversals { "dda", "mipgrid", "distance" };
+        bool rayCache = true; // --no-cache casts every ray every frame
+        std::vector<size_t> entityCounts { 100, 1000, 10000, 100000 };
+        std::vector<std::string> broadphases { "quadtree", "loose", "hash", "sap" };
+        bool broadphaseOnly = false; // skip the raycaster runs
+    };
+
+    struct BenchMap {
+        std::string name;
+        std::filesystem::path path;
+        size_t width;
+        size_t height;
+        bool open; // generated by writeOpenTileMap instead of writeRandomTileMap
+    };
+
+    struct CameraPose {
+        sf::Vector2f position;
+        float heading; // degrees
+    };
+
+    struct BenchResult {
+        std::string map;
+        size_t width {};
+        size_t height {};
+        std::string path;
+        std::string traversal;
+        std::string skipped; // reason, empty if the run happened
+        size_t frames {};
+        size_t rays {};
+        size_t raysCast {}; // rays the cache didn't cover
+        double seconds {};
+        double raysPerSecond {};
+        double nsPerRay {};
+        double frameMsP50 {};
+        double frameMsP99 {};
+        double allocationsPerFrame {};
+        double loadSeconds {};
+    };
+
+    struct BroadphaseResult {
+        std::string broadphase;
+        size_t entities {};
+        size_t frames {};
+        double updateMs {}; // per frame
+        double queryMs {}; // all queriesPerFrame queries of a frame
+        double pairsMs {};
+        double pairsPerFrame {};
+        double allocationsPerFrame {};
+    };
+
+    bool parseOptions(int argc, char** argv, BenchOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (argument == "--json" && hasValue) options.jsonPath = argv[++i];
+            else if (argument == "--frames" && hasValue) options.frames = std::stoul(argv[++i]);
+            else if (argument == "--rays" && hasValue) options.rays = std::stoul(argv[++i]);
+            else if (argument == "--threads" && hasValue) options.threads = std::stoul(argv[++i]);
+            else if (argument == "--max-tiles" && hasValue) options.maxTiles = std::stoul(argv[++i]);
+            else if (argument == "--binary") options.binary = true;
+            else if (argument == "--stream" && hasValue) options.streamBudgetMb = std::stoul(argv[++i]);
+            else if (argument == "--traversal" && hasValue) options.traversals = { argv[++i] };
+            else if (argument == "--no-cache") options.rayCache = false;
+            else if (argument == "--seed" && hasValue) options.seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+            else if (argument == "--broadphase" && hasValue) options.broadphases = { argv[++i] };
+            else if (argument == "--broadphase-only") options.broadphaseOnly = true;
+            else if ((argument == "--sizes" || argument == "--entities") && hasValue) {
+                std::vector<size_t>& values = argument == "--sizes" ? options.sizes : options.entityCounts;
+                values.clear();
+                std::stringstream list(argv[++i]);
+                std::string value;
+                while (std::getline(list, value, ',')) if (!value.empty()) values.push_back(std::stoul(value));
+            } else {
+                std::cerr << "unknown or incomplete option: " << argument << std::endl;
+                return false;
+            }
+        }
+        return options.frames > 0;
+    }
+
+    double percentile(std::vector<double> values, double fraction) {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        size_t index = static_cast<size_t>(fraction * (values.size() - 1) + 0.5);
+        return values[std::min(index, values.size() - 1)];
+    }
+
+    void writeBinaryMap(const std::filesystem::path& textPath, const std::filesystem::path& binaryPath, const std::array<std::shared_ptr<Tile>, Constants::TILES_NUMBER>& tileTypes) {
+        size_t width = 0, height = 0;
+        std::vector<uint16_t> cells = tilemapfile::readTextTileMap(textPath, width, height);
+        std::vector<tilemapfile::TileTypeRecord> records(tileTypes.size());
+        for (size_t i = 0; i < tileTypes.size(); ++i) {
+            sf::IntRect rect = tileTypes[i]->getTextureRect();
+            records[i] = { rect.left, rect.top, rect.width, rect.height, static_cast<uint8_t>(tileTypes[i]->getWalkable()), {} };
+        }
+        tilemapfile::writeBinaryTileMap(binaryPath, width, height, cells, records);
+    }
+
+    // walkable floor with a wall on 1 tile in 100, where empty-space skipping has room to work
+    void writeOpenTileMap(const std::filesystem::path& filePath, size_t width, size_t height) {
+        unsigned int floor = 0, wall = 0;
+        for (unsigned int i = 0; i < Constants::TILES_NUMBER; ++i) {
+            if (Constants::TILES_BOOLS[i]) floor = i;
+            else wall = i;
+        }
+
+        std::ofstream file(filePath);
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) file << (std::rand() % 100 == 0 ? wall : floor) << (x + 1 < width ? " " : "\n");
+        }
+    }
+
+    sf::Vector2f cellCenter(const TileMap& map, size_t x, size_t y) {
+        return map.getTileMapPosition() + sf::Vector2f((x + 0.5f) * map.getTileWidth(), (y + 0.5f) * map.getTileHeight());
+    }
+
+    const std::vector<std::string> pathNames { "spin", "tour", "idle", "pan" };
+
+    /* "spin": one full turn in place from the walkable cell closest to the map centre (what the game scene does),
+    "tour": walks through walkable cells spread over the whole map, turning 37 degrees per frame,
+    "idle": stands still at the spin cell, "pan": turns there by two ray angle steps per frame (both hit the ray cache) */
+    std::vector<CameraPose> makeCameraPath(const TileMap& map, const std::string& name, size_t frames, float angleStep) {
+        std::vector<size_t> walkable;
+        for (size_t y = 0; y < map.getTileMapHeight(); ++y) {
+            for (size_t x = 0; x < map.getTileMapWidth(); ++x) {
+                if (map.isWalkable(x, y)) walkable.push_back(y * map.getTileMapWidth() + x);
+            }
+        }
+
+        std::vector<CameraPose> path;
+        if (walkable.empty()) return path;
+        size_t width = map.getTileMapWidth();
+
+        if (name != "tour") {
+            float centerX = width / 2.0f, centerY = map.getTileMapHeight() / 2.0f;
+            size_t best = *std::min_element(walkable.begin(), walkable.end(), [&](size_t a, size_t b) {
+                float ax = a % width - centerX, ay = a / width - centerY, bx = b % width - centerX, by = b / width - centerY;
+                return ax * ax + ay * ay < bx * bx + by * by;
+            });
+            sf::Vector2f position = cellCenter(map, best % width, best / width);
+            for (size_t frame = 0; frame < frames; ++frame) {
+                float heading = name == "spin" ? static_cast<float>(frame % 360) : name == "pan" ? std::fmod(frame * 2 * angleStep, 360.0f) : 0.0f;
+                path.push_back({ position, heading });
+            }
+        } else {
+            for (size_t frame = 0; frame < frames; ++frame) {
+                size_t cell = walkable[frame * walkable.size() / frames];
+                path.push_back({ cellCenter(map, cell % width, cell / width), static_cast<float>((frame * 37) % 360) });
+            }
+        }
+        return path;
+    }
+
+    BenchResult runPath(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& map, const BenchMap& info, const std::string& pathName, const std::vector<CameraPose>& path, const std::string& traversal, JobSystem& jobSystem) {
+        BenchResult result;
+        result.map = info.name;
+        result.width = info.width;
+        result.height = info.height;
+        result.path = pathName;
+        result.traversal = traversal;
+        physics::RayTraversal rayTraversal = physics::parseRayTraversal(traversal);
+
+        if (path.empty()) {
+            result.skipped = "no walkable tile";
+            return result;
+        }
+
+        sf::VertexArray rays;
+        auto setPose = [&](const CameraPose& pose) {
+            player->changePosition(pose.position);
+            player->updatePos();
+            player->setHeadingAngle(pose.heading);
+        };
+
+        // warm up: sizes the ray table and every per-frame buffer, builds the distance field
+        auto updateStreaming = [&] { map->updateStreaming(player->getSpritePos(), player->getDirectionVector(), physics::maxRayDistance); };
+        setPose(path.front());
+        map->prefetch(player->getSpritePos());
+        updateStreaming();
+        physics::calculateRayCast3d(player, map, rays, rayTraversal, &jobSystem);
+
+        std::vector<double> frameMs;
+        frameMs.reserve(path.size());
+        size_t allocations = 0;
+        size_t raysCast = 0;
+
+        for (const CameraPose& pose : path) {
+            setPose(pose);
+            size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+
+            updateStreaming(); // no-op unless streaming
+            physics::calculateRayCast3d(player, map, rays, rayTraversal, &jobSystem);
+
+            auto end = std::chrono::steady_clock::now();
+            raysCast += physics::cachedRayCastFrame.castCount;
+            allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            frameMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        size_t raysPerFrame = physics::cachedRayCastFrame.columns.size();
+        result.frames = path.size();
+        result.rays = raysPerFrame * path.size();
+        result.raysCast = raysCast;
+        result.seconds = std::accumulate(frameMs.begin(), frameMs.end(), 0.0) / 1000.0;
+        result.raysPerSecond = result.seconds > 0.0 ? result.rays / result.seconds : 0.0;
+        result.nsPerRay = result.rays ? result.seconds * 1e9 / result.rays : 0.0;
+        result.frameMsP50 = percentile(frameMs, 0.50);
+        result.frameMsP99 = percentile(frameMs, 0.99);
+        result.allocationsPerFrame = static_cast<double>(allocations) / path.size();
+        return result;
+    }
+
+    /* count sprites of one tile walk straight lines at 0.5 to 2 px per frame, bouncing off the edges of a square world
+    with about one sprite per 8 tiles; every frame times update(), queriesPerFrame queries of 8x8 tiles and findPairs */
+    BroadphaseResult runBroadphase(const std::string& name, std::vector<std::unique_ptr<Static>>& sprites, size_t count, size_t frames, unsigned int seed) {
+        const size_t queriesPerFrame = 64;
+        BroadphaseResult result;
+        result.broadphase = name;
+        result.entities = count;
+        result.frames = frames;
+
+        sf::Vector2f tile(Constants::TILE_WIDTH, Constants::TILE_HEIGHT);
+        float side = std::ceil(std::sqrt(count * 8.0f));
+        sf::FloatRect world(0.0f, 0.0f, side * tile.x, side * tile.y);
+        std::unique_ptr<physics::Broadphase> broadphase = physics::makeBroadphase(physics::parseBroadphaseKind(name), world, sf::Vector2f(), tile);
+
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<sf::Vector2f> velocities(count);
+        for (size_t i = 0; i < count; ++i) {
+            sf::Sprite& shape = sprites[i]->returnSpritesShape();
+            shape.setPosition(unit(random) * (world.width - tile.x), unit(random) * (world.height - tile.y));
+            float angle = unit(random) * 6.2831853f, speed = 0.5f + 1.5f * unit(random);
+            velocities[i] = sf::Vector2f(std::cos(angle), std::sin(angle)) * speed;
+            broadphase->insert(sprites[i].get());
+        }
+
+        std::vector<Sprite*> found;
+        std::vector<std::pair<Sprite*, Sprite*>> pairs;
+        auto step = [&] {
+            for (size_t i = 0; i < count; ++i) {
+                sf::Sprite& shape = sprites[i]->returnSpritesShape();
+                sf::Vector2f position = shape.getPosition() + velocities[i];
+                if (position.x < 0.0f || position.x > world.width - tile.x) velocities[i].x = -velocities[i].x;
+                if (position.y < 0.0f || position.y > world.height - tile.y) velocities[i].y = -velocities[i].y;
+                shape.setPosition(position);
+            }
+        };
+
+        // warm up: every buffer (and the loose tree's nodes) grows to this count
+        broadphase->update();
+        broadphase->findPairs(pairs);
+
+        double updateMs = 0.0, queryMs = 0.0, pairsMs = 0.0;
+        size_t allocations = 0, pairCount = 0;
+        for (size_t frame = 0; frame < frames; ++frame) {
+            step();
+            size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+
+            auto start = std::chrono::steady_clock::now();
+            broadphase->update();
+            auto updated = std::chrono::steady_clock::now();
+            for (size_t query = 0; query < queriesPerFrame; ++query) {
+                found.clear();
+                sf::Vector2f corner(unit(random) * world.width, unit(random) * world.height);
+                broadphase->query(sf::FloatRect(corner, tile * 8.0f), found);
+            }
+            auto queried = std::chrono::steady_clock::now();
+            pairs.clear();
+            broadphase->findPairs(pairs);
+            auto end = std::chrono::steady_clock::now();
+
+            allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            pairCount += pairs.size();
+            updateMs += std::chrono::duration<double, std::milli>(updated - start).count();
+            queryMs += std::chrono::duration<double, std::milli>(queried - updated).count();
+            pairsMs += std::chrono::duration<double, std::milli>(end - queried).count();
+        }
+
+        result.updateMs = updateMs / frames;
+        result.queryMs = queryMs / frames;
+        result.pairsMs = pairsMs / frames;
+        result.pairsPerFrame = static_cast<double>(pairCount) / frames;
+        result.allocationsPerFrame = static_cast<double>(allocations) / frames;
+        return result;
+    }
+
+    std::string jsonEscape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    bool writeJson(const std::filesystem::path& filePath, const std::vector<BenchResult>& results, const std::vector<BroadphaseResult>& broadphaseResults, size_t raysPerFrame, size_t threads) {
+        std::ofstream file(filePath);
+        if (!file.is_open()) return false;
+
+        file << "{\n";
+        file << "  \"rays_per_frame\": " << raysPerFrame << ",\n";
+        file << "  \"threads\": " << threads << ",\n";
+        file << "  \"kernel\": \"" << jsonEscape(physics::rayKernelName(physics::detectRayKernel())) << "\",\n";
+        file << "  \"runs\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            file << "    { \"map\": \"" << jsonEscape(r.map) << "\", \"width\": " << r.width << ", \"height\": " << r.height
+                 << ", \"path\": \"" << r.path << "\", \"traversal\": \"" << jsonEscape(r.traversal) << "\"";
+            if (!r.skipped.empty()) {
+                file << ", \"skipped\": \"" << jsonEscape(r.skipped) << "\" }";
+            } else {
+                file << ", \"frames\": " << r.frames << ", \"rays\": " << r.rays << ", \"rays_cast\": " << r.raysCast << ", \"load_seconds\": " << r.loadSeconds
+                     << ", \"rays_per_sec\": " << r.raysPerSecond << ", \"ns_per_ray\": " << r.nsPerRay
+                     << ", \"frame_ms_p50\": " << r.frameMsP50 << ", \"frame_ms_p99\": " << r.frameMsP99
+                     << ", \"allocs_per_frame\": " << r.allocationsPerFrame << " }";
+            }
+            file << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        file << "  ],\n";
+        file << "  \"broadphase\": [\n";
+        for (size_t i = 0; i < broadphaseResults.size(); ++i) {
+            const BroadphaseResult& r = broadphaseResults[i];
+            file << "    { \"broadphase\": \"" << jsonEscape(r.broadphase) << "\", \"entities\": " << r.entities << ", \"frames\": " << r.frames
+                 << ", \"update_ms\": " << r.updateMs << ", \"query_ms\": " << r.queryMs << ", \"pairs_ms\": " << r.pairsMs
+                 << ", \"pairs_per_frame\": " << r.pairsPerFrame << ", \"allocs_per_frame\": " << r.allocationsPerFrame << " }";
+            file << (i + 1 < broadphaseResults.size() ? ",\n" : "\n");
+        }
+        file << "  ]\n}\n";
+        return true;
+    }
+
+    void printResult(const BenchResult& r) {
+        if (!r.skipped.empty()) {
+            std::printf("%-14s %5zux%-5zu %-5s %-8s skipped: %s\n", r.map.c_str(), r.width, r.height, r.path.c_str(), r.traversal.c_str(), r.skipped.c_str());
+            return;
+        }
+        std::printf("%-14s %5zux%-5zu %-5s %-8s %12.0f rays/s %9.1f ns/ray  p50 %8.3f ms  p99 %8.3f ms  %6.2f allocs/frame  cast %5.1f%%  load %9.3f ms\n",
+                    r.map.c_str(), r.width, r.height, r.path.c_str(), r.traversal.c_str(), r.raysPerSecond, r.nsPerRay, r.frameMsP50, r.frameMsP99, r.allocationsPerFrame, r.rays ? 100.0 * r.raysCast / r.rays : 0.0, r.loadSeconds * 1000.0);
+    }
+
+    void printBroadphaseResult(const BroadphaseResult& r) {
+        std::printf("%-9s %7zu sprites  update %8.3f ms  64 queries %8.3f ms  pairs %8.3f ms (%9.1f pairs)  %6.2f allocs/frame\n",
+                    r.broadphase.c_str(), r.entities, r.updateMs, r.queryMs, r.pairsMs, r.pairsPerFrame, r.allocationsPerFrame);
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    testing::loadConfig();
+    if (options.rays) Constants::RAYS_NUM = options.rays * 2; // calculateRayCast3d casts RAYS_NUM / 2 columns
+    size_t threads = options.threads ? options.threads : Constants::WORKER_THREADS;
+    Constants::RAY_CACHE = options.rayCache;
+    MetaComponents::bigView = sf::View(sf::FloatRect(0, 0, Constants::WORLD_WIDTH, Constants::WORLD_HEIGHT));
+
+    JobSystem jobSystem(threads);
+    std::shared_ptr<sf::Texture> texture = std::make_shared<sf::Texture>(); // never created, so no GL context is needed
+    std::array<std::shared_ptr<Tile>, Constants::TILES_NUMBER> tileTypes = testing::makeTileTypes(texture);
+
+    std::unique_ptr<Player> player = std::make_unique<Player>(sf::Vector2f(), sf::Vector2f(1.0f, 1.0f), texture, 0.0f, sf::Vector2f(),
+                                                              std::vector<sf::IntRect>{ sf::IntRect(0, 0, 1, 1) }, 1, std::vector<std::weak_ptr<sf::Uint8[]>>());
+
+    std::vector<BenchMap> maps { { "tilemap.txt", Constants::TILEMAP_FILEPATH, Constants::TILEMAP_WIDTH, Constants::TILEMAP_HEIGHT, false } };
+    std::srand(options.seed); // both generators use rand(), so the maps are the same every run
+    for (size_t size : options.sizes) {
+        for (bool open : { false, true }) {
+            std::string name = (open ? "open" : "random") + std::to_string(size);
+            maps.push_back({ name, std::filesystem::temp_directory_path() / ("raycast_bench_" + name + ".txt"), size, size, open });
+        }
+    }
+
+    std::vector<BenchResult> results;
+    if (options.broadphaseOnly) maps.clear();
+    for (const BenchMap& info : maps) {
+        if (info.width * info.height > options.maxTiles) {
+            for (const std::string& pathName : pathNames) {
+                for (const std::string& traversal : options.traversals) {
+                    BenchResult skipped;
+                    skipped.map = info.name;
+                    skipped.width = info.width;
+                    skipped.height = info.height;
+                    skipped.path = pathName;
+                    skipped.traversal = traversal;
+                    skipped.skipped = "more than --max-tiles " + std::to_string(options.maxTiles) + " tiles";
+                    printResult(skipped);
+                    results.push_back(skipped);
+                }
+            }
+            continue;
+        }
+
+        if (info.name != "tilemap.txt") {
+            Constants::TILEMAP_WIDTH = info.width;
+            Constants::TILEMAP_HEIGHT = info.height;
+            if (info.open) writeOpenTileMap(info.path, info.width, info.height);
+            else Constants::writeRandomTileMap(info.path);
+        }
+        std::filesystem::path loadPath = info.path;
+        if (options.binary) {
+            loadPath = std::filesystem::temp_directory_path() / ("raycast_bench_" + info.name + ".rcmap");
+            writeBinaryMap(info.path, loadPath, tileTypes);
+        }
+
+        auto loadStart = std::chrono::steady_clock::now(); // map load only, not generating or converting it
+        std::unique_ptr<TileMap> map = std::make_unique<TileMap>(tileTypes.data(), Constants::TILES_NUMBER, info.width, info.height, Constants::TILE_WIDTH, Constants::TILE_HEIGHT, loadPath, Constants::TILEMAP_POSITION);
+        double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+
+        // paths are picked from the whole map, before streaming drops every chunk
+        std::vector<std::vector<CameraPose>> paths;
+        float angleStep = static_cast<float>(Constants::FOV) / (Constants::RAYS_NUM / 2);
+        for (const std::string& pathName : pathNames) paths.push_back(makeCameraPath(*map, pathName, options.frames, angleStep));
+        if (options.streamBudgetMb) map->enableStreaming(options.streamBudgetMb * 1024 * 1024, Constants::TILEMAP_STREAMING_PIN_RADIUS);
+
+        for (size_t pathIndex = 0; pathIndex < paths.size(); ++pathIndex) {
+            for (const std::string& traversal : options.traversals) {
+                BenchResult result = runPath(player, map, info, pathNames[pathIndex], paths[pathIndex], traversal, jobSystem);
+                result.loadSeconds = loadSeconds;
+                printResult(result);
+                results.push_back(result);
+            }
+        }
+
+        map.reset(); // unmaps a binary file before it's removed
+        if (info.name != "tilemap.txt") std::filesystem::remove(info.path);
+        if (options.binary) std::filesystem::remove(loadPath);
+    }
+
+    // sprites are made once for the largest count, smaller runs use the first ones
+    std::vector<BroadphaseResult> broadphaseResults;
+    size_t maxEntities = options.entityCounts.empty() ? 0 : *std::max_element(options.entityCounts.begin(), options.entityCounts.end());
+    std::vector<std::unique_ptr<Static>> sprites;
+    sprites.reserve(maxEntities);
+    for (size_t i = 0; i < maxEntities; ++i) {
+        sprites.push_back(std::make_unique<Static>(sf::Vector2f(), sf::Vector2f(1.0f, 1.0f), std::weak_ptr<sf::Texture>()));
+        sprites.back()->returnSpritesShape().setTextureRect(sf::IntRect(0, 0, Constants::TILE_WIDTH, Constants::TILE_HEIGHT)); // bounds of one tile, no texture needed
+    }
+    size_t broadphaseFrames = std::min<size_t>(options.frames, 120);
+    for (size_t count : options.entityCounts) {
+        for (const std::string& broadphase : options.broadphases) {
+            BroadphaseResult result = runBroadphase(broadphase, sprites, count, broadphaseFrames, options.seed);
+            printBroadphaseResult(result);
+            broadphaseResults.push_back(result);
+        }
+    }
+
+    if (!options.jsonPath.empty()) {
+        if (!writeJson(options.jsonPath, results, broadphaseResults, Constants::RAYS_NUM / 2, jobSystem.getThreadCount())) {
+            std::cerr << "could not write " << options.jsonPath << std::endl;
+            return 1;
+        }
+        std::printf("wrote %s\n", options.jsonPath.string().c_str());
+    }
+    return 0;
+}
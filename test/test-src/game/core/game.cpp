@@ -3,8 +3,8 @@
 
 // GameManager constructor sets up the window, intitializes constant variables, calls the random function, and makes scenes 
 GameManager::GameManager()
-    : mainWindow(Constants::VIEW_SIZE_X, Constants::VIEW_SIZE_Y, Constants::GAME_TITLE, Constants::FRAME_LIMIT) {
-    gameScene = std::make_unique<gamePlayScene>(mainWindow.getWindow());
+    : mainWindow(Constants::VIEW_SIZE_X, Constants::VIEW_SIZE_Y, Constants::GAME_TITLE, Constants::FRAME_LIMIT), jobSystem(Constants::WORKER_THREADS) {
+    gameScene = std::make_unique<gamePlayScene>(mainWindow.getWindow(), jobSystem);
 
     log_info("\tGame initialized");
 }
@@ -12,6 +12,7 @@
 #include <SFML/Graphics.hpp>
 
 #include "../scenes/scenes.hpp"
+#include "jobs.hpp"
 
 class GameManager {
 public:
@@ -26,6 +27,7 @@ private:
     void handleEventInput(); // handleEventInput taks input from device, such as keyboard, mouse, etc 
 
     GameWindow mainWindow;
+    JobSystem jobSystem; // worker threads live as long as the game
 
     std::unique_ptr<gamePlayScene> gameScene;
 };
@@ -0,0 +1,127 @@
+//
+//  jobs.cpp
+//
+//
+
+#include "jobs.hpp"
+
+#include <algorithm>
+
+JobSystem::JobSystem(size_t threadCount) {
+    if (!threadCount) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    queues.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) queues.emplace_back(std::make_unique<WorkQueue>());
+
+    workers.reserve(threadCount - 1);
+    for (size_t slot = 1; slot < threadCount; ++slot) workers.emplace_back(&JobSystem::workerLoop, this, slot);
+
+    log_info("Job system started with " + std::to_string(threadCount) + " threads");
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void JobSystem::run(size_t count, size_t chunkSize, const RangeTask& func) {
+    if (!count) return;
+    chunkSize = std::max<size_t>(1, chunkSize);
+
+    // not worth waking anyone up
+    if (workers.empty() || count <= chunkSize) {
+        func.invoke(func.context, 0, count, 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+
+    size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    task.store(&func);
+    pendingChunks.store(chunkCount);
+
+    // the last batch drained every queue; rewinding keeps their storage
+    for (auto& queue : queues) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->ranges.clear();
+        queue->head = 0;
+    }
+
+    // deal neighbouring chunks to the same queue so each thread starts on a contiguous block of the range
+    size_t perQueue = (chunkCount + queues.size() - 1) / queues.size();
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        auto& queue = *queues[chunk / perQueue];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.ranges.push_back({ chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize) });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        ++generation;
+    }
+    wakeCondition.notify_all();
+
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCondition.wait(lock, [this] { return pendingChunks.load() == 0; });
+    task.store(nullptr);
+}
+
+void JobSystem::workerLoop(size_t slot) {
+    size_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait(lock, [this, seenGeneration] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+        runChunks(slot);
+    }
+}
+
+void JobSystem::runChunks(size_t slot) {
+    Range range;
+    while (popRange(slot, range)) {
+        try {
+            const RangeTask* func = task.load();
+            if (func) func->invoke(func->context, range.begin, range.end, slot);
+        } catch (const std::exception& e) {
+            log_error("Exception in job system worker " + std::to_string(slot) + ": " + std::string(e.what()));
+        }
+
+        if (pendingChunks.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            doneCondition.notify_one();
+        }
+    }
+}
+
+// takes from the front of the thread's own queue, otherwise steals from the back of another one
+bool JobSystem::popRange(size_t slot, Range& range) {
+    {
+        auto& own = *queues[slot];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.head < own.ranges.size()) {
+            range = own.ranges[own.head++];
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        auto& victim = *queues[(slot + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.head < victim.ranges.size()) {
+            range = victim.ranges.back();
+            victim.ranges.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,67 @@
+//
+//  jobs.hpp
+//
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "../test-logging/log.hpp"
+
+/* JobSystem keeps a fixed set of worker threads alive for the whole game. parallelFor splits an index range into chunks,
+spreads them over per-worker queues and lets idle workers steal from the others, then blocks until every chunk is done */
+class JobSystem {
+public:
+    explicit JobSystem(size_t threadCount = 0); // 0 uses every hardware thread
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /* runs func(begin, end, slot) over [0, count) in chunks of chunkSize, slot being the running thread's index; the calling
+    thread works as slot 0 and returns once all chunks finished. func is only borrowed for the call, so a lambda capturing
+    any number of references costs no allocation */
+    template<typename Func>
+    void parallelFor(size_t count, size_t chunkSize, const Func& func) {
+        run(count, chunkSize, { &func, [](const void* context, size_t begin, size_t end, size_t slot) { (*static_cast<const Func*>(context))(begin, end, slot); } });
+    }
+    size_t getThreadCount() const { return queues.size(); } // workers plus the calling thread
+
+private:
+    // the caller's callable behind a plain pointer and a function that knows its type
+    struct RangeTask {
+        const void* context;
+        void (*invoke)(const void* context, size_t begin, size_t end, size_t slot);
+    };
+    struct Range { size_t begin; size_t end; };
+    struct WorkQueue {
+        std::mutex mutex;
+        std::vector<Range> ranges; // [head, size) still to run; keeps its capacity between batches
+        size_t head {};
+    };
+
+    void run(size_t count, size_t chunkSize, const RangeTask& func);
+    void workerLoop(size_t slot);
+    void runChunks(size_t slot);
+    bool popRange(size_t slot, Range& range);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues; // one per slot, index 0 belongs to the calling thread
+    std::vector<std::thread> workers;
+
+    std::mutex batchMutex; // one parallelFor at a time
+    std::atomic<const RangeTask*> task { nullptr };
+    std::atomic<size_t> pendingChunks { 0 };
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    size_t generation {};
+    bool stopping = false;
+
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+};
@@ -5,6 +5,10 @@
 
 #include "globals.hpp"  
 
+#include <algorithm>
+#include <cstring>
+#include <new>
+
 namespace MetaComponents {
     sf::Clock clock;
     sf::View smallView; 
@@ -132,6 +136,17 @@ namespace Constants {
             VIEW_RECT = { 0.0f, 0.0f, VIEW_SIZE_X, VIEW_SIZE_Y };
             FOV = config["world"]["FOV"].as<unsigned short>(); 
             RAYS_NUM = config["world"]["rays_num"].as<size_t>(); 
+            WORKER_THREADS = config["world"]["worker_threads"].as<unsigned short>(); 
+            SOFTWARE_RENDERER = config["world"]["software_renderer"].as<bool>(); 
+            FLOOR_CASTING = config["world"]["floor_casting"].as<bool>(); 
+            RAY_TRAVERSAL = config["world"]["ray_traversal"].as<std::string>(); 
+            RAY_CACHE = config["world"]["ray_cache"].as<bool>(); 
+            VISIBLE_CELLS = config["world"]["visible_cells"].as<bool>(); 
+            BROADPHASE = config["world"]["broadphase"].as<std::string>(); 
+            DYNAMIC_RESOLUTION = config["world"]["dynamic_resolution"]["enabled"].as<bool>(); 
+            RAYS_MIN = config["world"]["dynamic_resolution"]["rays_min"].as<size_t>(); 
+            RAYS_MAX = config["world"]["dynamic_resolution"]["rays_max"].as<size_t>(); 
+            FRAME_TIME_TARGET_MS = config["world"]["dynamic_resolution"]["target_ms"].as<float>(); 
 
             // Load score settings
             INITIAL_SCORE = config["score"]["initial"].as<unsigned short>(); 
@@ -209,6 +224,9 @@ namespace Constants {
             TILEMAP_HEIGHT = config["tilemap"]["height"].as<size_t>();
             TILEMAP_BOUNDARYOFFSET = config["tilemap"]["boundary_offset"].as<float>();
             TILEMAP_FILEPATH = config["tilemap"]["filepath"].as<std::string>();
+            TILEMAP_STREAMING = config["tilemap"]["streaming"].as<bool>();
+            TILEMAP_STREAMING_BUDGET_MB = config["tilemap"]["streaming_budget_mb"].as<size_t>();
+            TILEMAP_STREAMING_PIN_RADIUS = config["tilemap"]["streaming_pin_radius"].as<unsigned short>();
 
             // Load text settings
             TEXT_SIZE = config["text"]["size"].as<unsigned short>();
@@ -323,6 +341,13 @@ namespace Constants {
         }
     }
 
+    std::shared_ptr<sf::Uint8[]> makeBitmask(unsigned int width, unsigned int height) {
+        size_t bytes = std::max<size_t>(bitmaskRowWords(width) * height, 1) * sizeof(uint64_t);
+        sf::Uint8* data = static_cast<sf::Uint8*>(::operator new[](bytes, std::align_val_t(32)));
+        std::memset(data, 0, bytes);
+        return std::shared_ptr<sf::Uint8[]>(data, [](sf::Uint8* pointer) { ::operator delete[](pointer, std::align_val_t(32)); });
+    }
+
     std::shared_ptr<sf::Uint8[]> createBitmask( const std::shared_ptr<sf::Texture>& texture, const sf::IntRect& rect, const float transparency) {
         if (!texture) {
             log_warning("\tfailed to create bitmask ( texture is empty )");
@@ -342,20 +367,17 @@ namespace Constants {
         unsigned int width = rect.width;
         unsigned int height = rect.height;
 
-        unsigned int bitmaskSize = (width * height) / 8 + ((width * height) % 8 != 0); // rounding up
-        std::shared_ptr<sf::Uint8[]> bitmask(new sf::Uint8[bitmaskSize](), std::default_delete<sf::Uint8[]>());
+        std::shared_ptr<sf::Uint8[]> bitmask = makeBitmask(width, height);
+        uint64_t* words = reinterpret_cast<uint64_t*>(bitmask.get());
 
         for (unsigned int y = 0; y < height; ++y) {
             for (unsigned int x = 0; x < width; ++x) {
                 sf::Color pixelColor = image.getPixel(rect.left + x, rect.top + y);
-                unsigned int bitIndex = y * width + x;
-                unsigned int byteIndex = bitIndex / 8;
-                unsigned int bitPosition = bitIndex % 8;
 
                 // Use transparency threshold if provided, otherwise default to alpha > 128
                 if ((transparency > 0.0f && pixelColor.a >= static_cast<sf::Uint8>(transparency * 255)) || 
                     (transparency <= 0.0f && pixelColor.a > 128)) {
-                    bitmask[byteIndex] |= (1 << bitPosition);
+                    words[y * bitmaskRowWords(width) + x / 64] |= uint64_t(1) << (x % 64);
                 }
             }
         }
@@ -382,8 +404,8 @@ namespace Constants {
         unsigned int width = rect.width;
         unsigned int height = rect.height;
 
-        unsigned int bitmaskSize = (width * height) / 8 + ((width * height) % 8 != 0); // rounding up
-        std::shared_ptr<sf::Uint8[]> bitmask(new sf::Uint8[bitmaskSize](), std::default_delete<sf::Uint8[]>());
+        std::shared_ptr<sf::Uint8[]> bitmask = makeBitmask(width, height);
+        uint64_t* words = reinterpret_cast<uint64_t*>(bitmask.get());
 
         // Start processing only the last selected rows of the rectangle
         unsigned int startRow = (height >= rows) ? height - rows : 0;
@@ -391,14 +413,11 @@ namespace Constants {
         for (unsigned int y = startRow; y < height; ++y) {
             for (unsigned int x = 0; x < width; ++x) {
                 sf::Color pixelColor = image.getPixel(rect.left + x, rect.top + y);
-                unsigned int bitIndex = y * width + x;
-                unsigned int byteIndex = bitIndex / 8;
-                unsigned int bitPosition = bitIndex % 8;
 
                 // Use transparency threshold if provided, otherwise default to alpha > 128
                 if ((transparency > 0.0f && pixelColor.a >= static_cast<sf::Uint8>(transparency * 255)) || 
                     (transparency <= 0.0f && pixelColor.a > 128)) {
-                    bitmask[byteIndex] |= (1 << bitPosition);
+                    words[y * bitmaskRowWords(width) + x / 64] |= uint64_t(1) << (x % 64);
                 }
             }
         }
@@ -410,11 +429,7 @@ namespace Constants {
 
     for (unsigned int y = 0; y < height; ++y) {
         for (unsigned int x = 0; x < width; ++x) {
-            unsigned int bitIndex = y * width + x;
-            unsigned int byteIndex = bitIndex / 8;
-            int bitPosition = 7 - (bitIndex % 8); // High bit to low bit order
-
-            if (bitmask[byteIndex] & (1 << bitPosition)) {
+            if (bitmaskPixel(bitmask, width, x, y)) {
                 bitmaskStream << '1';
             } else {
                 bitmaskStream << '0';
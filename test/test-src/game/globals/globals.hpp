@@ -8,6 +8,8 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 #include <vector>
+#include <memory>
+#include <cstdint>
 #include <iostream> 
 #include <sstream>
 #include <fstream> 
@@ -55,6 +57,16 @@ namespace Constants { // not actually "constants" in terms of being fixed, but s
 
     extern void writeRandomTileMap(const std::filesystem::path filePath); 
 
+    /* bitmasks are 1 bit per pixel in rows of 64 bit words, the lowest bit of a word being its leftmost pixel. Every row
+    has one more word than it needs, kept zero, so a row can be read 64 bits from any pixel on without a bounds check;
+    the buffer is 32 byte aligned for the AVX2 path of physics::pixelPerfectCollision */
+    inline size_t bitmaskRowWords(unsigned int width) { return (width + 63) / 64 + 1; }
+    inline bool bitmaskPixel(const std::shared_ptr<sf::Uint8[]>& bitmask, unsigned int width, unsigned int x, unsigned int y) {
+        const uint64_t* row = reinterpret_cast<const uint64_t*>(bitmask.get()) + y * bitmaskRowWords(width);
+        return (row[x / 64] >> (x % 64)) & 1u;
+    }
+    extern std::shared_ptr<sf::Uint8[]> makeBitmask(unsigned int width, unsigned int height); // all clear
+
     // load textures, fonts, music, and sound
     extern std::shared_ptr<sf::Uint8[]> createBitmask( const std::shared_ptr<sf::Texture>& texture, const sf::IntRect& rect, const float transparency = 0.0f);
     extern std::shared_ptr<sf::Uint8[]> createBitmaskForBottom( const std::shared_ptr<sf::Texture>& texture, const sf::IntRect& rect, const float transparency = 0.0f, int rows = 1);
@@ -64,6 +76,10 @@ namespace Constants { // not actually "constants" in terms of being fixed, but s
     extern void readFromYaml(const std::filesystem::path configFile); 
     extern void makeRectsAndBitmasks(); 
 
+    // Math
+    inline constexpr float PI = 3.14159265f;
+    inline constexpr float DEG_TO_RAD = PI / 180.0f;
+
     // Game display settings
     inline float WORLD_SCALE;
     inline unsigned short WORLD_WIDTH;
@@ -76,6 +92,17 @@ namespace Constants { // not actually "constants" in terms of being fixed, but s
     inline sf::FloatRect VIEW_RECT;
     inline unsigned short FOV;
     inline size_t RAYS_NUM;
+    inline unsigned short WORKER_THREADS; // 0 = one per hardware thread
+    inline bool SOFTWARE_RENDERER; // draw the 3d view into a CPU framebuffer instead of textured quads
+    inline bool FLOOR_CASTING; // fill floor and ceiling from the tile map (CPU pass, drawn under the walls)
+    inline std::string RAY_TRAVERSAL; // "dda", "mipgrid" (occupancy pyramid) or "distance" (distance-to-wall field), see physics::RayTraversal
+    inline bool RAY_CACHE; // reuse last frame's rays when the camera stands still or turns by whole ray steps
+    inline bool VISIBLE_CELLS; // build physics::VisibleCells from the rays every frame the columns change
+    inline std::string BROADPHASE; // "quadtree", "loose", "hash" or "sap", see physics::BroadphaseKind
+    inline bool DYNAMIC_RESOLUTION; // let ResolutionController pick the ray count between RAYS_MIN and RAYS_MAX
+    inline size_t RAYS_MIN;
+    inline size_t RAYS_MAX;
+    inline float FRAME_TIME_TARGET_MS; // cast plus draw time the controller aims for
 
     // Score settings
     inline unsigned short INITIAL_SCORE;
@@ -147,6 +174,9 @@ namespace Constants { // not actually "constants" in terms of being fixed, but s
     inline size_t TILEMAP_HEIGHT;
     inline float TILEMAP_BOUNDARYOFFSET; 
     inline std::filesystem::path TILEMAP_FILEPATH;
+    inline bool TILEMAP_STREAMING; // page chunks of a binary map in and out around the player instead of mapping all of it
+    inline size_t TILEMAP_STREAMING_BUDGET_MB; // resident chunk memory before least recently used chunks are dropped
+    inline unsigned short TILEMAP_STREAMING_PIN_RADIUS; // chunks around the player that are never evicted
 
     // Text settings
     inline unsigned short TEXT_SIZE;
@@ -0,0 +1,49 @@
+//
+//  broadphase.cpp
+//
+//
+
+#include "broadphase.hpp"
+#include "physics.hpp"
+#include "loosequadtree.hpp"
+#include "spatialhash.hpp"
+#include "sweepandprune.hpp"
+
+#include <algorithm>
+
+namespace physics {
+    BroadphaseKind parseBroadphaseKind(const std::string& name) {
+        if (name == "quadtree") return BroadphaseKind::QUADTREE;
+        if (name == "loose") return BroadphaseKind::LOOSE_QUADTREE;
+        if (name == "hash") return BroadphaseKind::SPATIAL_HASH;
+        if (name == "sap") return BroadphaseKind::SWEEP_AND_PRUNE;
+        log_warning("Unknown broadphase \"" + name + "\", using quadtree");
+        return BroadphaseKind::QUADTREE;
+    }
+
+    std::string broadphaseKindName(BroadphaseKind kind) {
+        switch (kind) {
+            case BroadphaseKind::LOOSE_QUADTREE: return "loose";
+            case BroadphaseKind::SPATIAL_HASH: return "hash";
+            case BroadphaseKind::SWEEP_AND_PRUNE: return "sap";
+            default: return "quadtree";
+        }
+    }
+
+    bool Broadphase::mayOverlap(const Sprite& a, const Sprite& b) const {
+        thread_local std::vector<Sprite*> nearby; // collision checks can run on the job threads
+        nearby.clear();
+        query(a.returnSpritesShape().getGlobalBounds(), nearby);
+        return std::find(nearby.begin(), nearby.end(), &b) != nearby.end();
+    }
+
+    std::unique_ptr<Broadphase> makeBroadphase(BroadphaseKind kind, const sf::FloatRect& worldBounds, sf::Vector2f gridOrigin, sf::Vector2f cellSize) {
+        log_info("Broadphase: " + broadphaseKindName(kind));
+        switch (kind) {
+            case BroadphaseKind::LOOSE_QUADTREE: return std::make_unique<LooseQuadtree>(worldBounds.left, worldBounds.top, worldBounds.width, worldBounds.height);
+            case BroadphaseKind::SPATIAL_HASH: return std::make_unique<SpatialHash>(gridOrigin, cellSize.x, cellSize.y);
+            case BroadphaseKind::SWEEP_AND_PRUNE: return std::make_unique<SweepAndPrune>();
+            default: return std::make_unique<Quadtree>(worldBounds.left, worldBounds.top, worldBounds.width, worldBounds.height);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+//
+//  broadphase.hpp
+//
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "../../test-assets/sprites/sprites.hpp"
+#include "raycast.hpp"
+
+namespace physics {
+    // spatial index the scene keeps its sprites in, picked with world: broadphase in config.yaml
+    enum class BroadphaseKind { QUADTREE, LOOSE_QUADTREE, SPATIAL_HASH, SWEEP_AND_PRUNE };
+    BroadphaseKind parseBroadphaseKind(const std::string& name); // unknown names fall back to the quadtree with a warning
+    std::string broadphaseKindName(BroadphaseKind kind);
+
+    enum class OverlapPhase { BEGIN, PERSIST, END };
+
+    // a change in an overlapping pair, reported by the broadphases that keep their pairs between frames
+    struct OverlapEvent {
+        Sprite* first;
+        Sprite* second;
+        OverlapPhase phase;
+    };
+
+    /* what every spatial index offers the scene: sprites are registered once and update() is called once per frame after
+    they moved; queries append to the caller's vector and report each sprite at most once, findPairs each overlapping pair */
+    class Broadphase {
+    public:
+        virtual ~Broadphase() = default;
+
+        template<typename SpriteType> void insert(std::unique_ptr<SpriteType>& obj) { insert(static_cast<Sprite*>(obj.get())); }
+        virtual void insert(Sprite* sprite) = 0;
+        virtual void remove(Sprite* sprite) = 0;
+        virtual void clear() = 0;
+        virtual void update() = 0;
+
+        virtual void query(const sf::FloatRect& area, std::vector<Sprite*>& result) const = 0; // sprites whose bounds intersect area
+        virtual void queryFrustum(const ViewFrustum& frustum, std::vector<Sprite*>& result) const = 0; // sprites in the view triangle
+        virtual void findPairs(std::vector<std::pair<Sprite*, Sprite*>>& pairs) const = 0; // sprites whose bounds intersect, as of the last update
+        // pre-check of a narrow test: b is near a as of the last update. the default queries a's current bounds and looks for b
+        virtual bool mayOverlap(const Sprite& a, const Sprite& b) const;
+        // what the last update changed in the overlapping pairs, or null when the index doesn't track pairs between frames
+        virtual const std::vector<OverlapEvent>* getOverlapEvents() const { return nullptr; }
+        virtual size_t getSpriteCount() const = 0;
+    };
+
+    // the quadtrees cover worldBounds, the spatial hash has cells of cellSize starting at gridOrigin (the tile map's layout)
+    std::unique_ptr<Broadphase> makeBroadphase(BroadphaseKind kind, const sf::FloatRect& worldBounds, sf::Vector2f gridOrigin, sf::Vector2f cellSize);
+}
@@ -0,0 +1,43 @@
+//
+//  bucketsort.hpp
+//
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../../test-assets/sprites/sprites.hpp"
+
+namespace physics {
+    /* the item layout the quadtree and the spatial hash share: items sorted by bucket (a node or a hashed cell) in one
+    array, bucket b owning [starts[b], starts[b + 1]). sortByBucket rebuilds it with a counting sort from itemBuckets[i],
+    the bucket of the i-th item itemAt(i) returns: count, prefix sum, scatter. O(n + buckets) and no allocation once the
+    vectors have grown */
+    template<typename Item, typename ItemAt>
+    void sortByBucket(const std::vector<uint32_t>& itemBuckets, size_t bucketCount, const ItemAt& itemAt, std::vector<uint32_t>& starts, std::vector<Item>& items) {
+        starts.assign(bucketCount + 1, 0);
+        for (uint32_t bucket : itemBuckets) ++starts[bucket + 1];
+        for (size_t bucket = 0; bucket < bucketCount; ++bucket) starts[bucket + 1] += starts[bucket];
+
+        items.resize(itemBuckets.size());
+        for (size_t i = 0; i < itemBuckets.size(); ++i) items[starts[itemBuckets[i]]++] = itemAt(i);
+        // the scatter moved every start to the next bucket's, shift them back
+        for (size_t bucket = bucketCount; bucket > 0; --bucket) starts[bucket] = starts[bucket - 1];
+        starts[0] = 0;
+    }
+
+    // forgets sprite: out of the inserted sprites, and out of the sorted items too, so queries before the next sort don't hand out a dead pointer. O(n)
+    template<typename Item>
+    void removeFromBuckets(Sprite* sprite, std::vector<Sprite*>& sprites, std::vector<uint32_t>& starts, std::vector<Item>& items) {
+        sprites.erase(std::remove(sprites.begin(), sprites.end(), sprite), sprites.end());
+
+        auto found = std::find_if(items.begin(), items.end(), [sprite](const Item& item) { return item.sprite == sprite; });
+        if (found == items.end()) return;
+        uint32_t removed = static_cast<uint32_t>(found - items.begin());
+        items.erase(found);
+        for (uint32_t& start : starts) if (start > removed) --start;
+    }
+}
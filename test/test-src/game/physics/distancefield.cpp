@@ -0,0 +1,145 @@
+//
+//  distancefield.cpp
+//
+//
+
+#include "distancefield.hpp"
+
+#include <algorithm>
+
+namespace physics {
+    DistanceField cachedDistanceField;
+
+    void DistanceField::sync(const TileMap& tileMap, JobSystem* jobSystem) {
+        if (mapId != tileMap.getMapId() || width != tileMap.getTileMapWidth() || height != tileMap.getTileMapHeight()) {
+            rebuild(tileMap, jobSystem);
+            return;
+        }
+        if (version == tileMap.getWalkableVersion()) return;
+
+        changes.clear();
+        if (!tileMap.getWalkableChangesSince(version, changes)) {
+            rebuild(tileMap, jobSystem);
+            return;
+        }
+        for (const sf::IntRect& changed : changes) rebuildRegion(tileMap, changed);
+        version = tileMap.getWalkableVersion();
+    }
+
+    void DistanceField::rebuild(const TileMap& tileMap, JobSystem* jobSystem) {
+        ScopedTimer timer("DistanceField rebuild (" + std::to_string(tileMap.getTileMapWidth()) + "x" + std::to_string(tileMap.getTileMapHeight()) + ")");
+
+        mapId = tileMap.getMapId();
+        version = tileMap.getWalkableVersion();
+        width = tileMap.getTileMapWidth();
+        height = tileMap.getTileMapHeight();
+        distances.assign(width * height, 0);
+        if (distances.empty()) return;
+
+        long mapWidth = static_cast<long>(width), mapHeight = static_cast<long>(height);
+        auto columns = [&](size_t begin, size_t end, size_t) {
+            transformColumns(tileMap, 0, 0, mapWidth, mapHeight, static_cast<long>(begin), static_cast<long>(end), distances.data());
+        };
+        auto rows = [&](size_t begin, size_t end, size_t) {
+            std::vector<int> scratch; // one per chunk, this only runs on load
+            for (size_t y = begin; y < end; ++y) transformRow(0, mapWidth, &distances[y * width], &distances[y * width], 0, mapWidth, scratch);
+        };
+
+        // the row pass needs every column finished, so the two passes are separate batches
+        if (jobSystem) {
+            jobSystem->parallelFor(width, std::max<size_t>(64, width / (jobSystem->getThreadCount() * 4)), columns);
+            jobSystem->parallelFor(height, std::max<size_t>(16, height / (jobSystem->getThreadCount() * 4)), rows);
+        } else {
+            columns(0, width, 0);
+            rows(0, height, 0);
+        }
+    }
+
+    void DistanceField::rebuildRegion(const TileMap& tileMap, const sf::IntRect& changed) {
+        // cells further than maxDistance from the change keep their value; the ones within it only see walls within 2 * maxDistance
+        long mapWidth = static_cast<long>(width), mapHeight = static_cast<long>(height);
+        auto clampX = [&](long x) { return std::clamp(x, 0L, mapWidth); };
+        auto clampY = [&](long y) { return std::clamp(y, 0L, mapHeight); };
+        long reach = maxDistance;
+
+        long outLeft = clampX(changed.left - reach), outRight = clampX(changed.left + changed.width + reach);
+        long outTop = clampY(changed.top - reach), outBottom = clampY(changed.top + changed.height + reach);
+        long windowX = clampX(changed.left - 2 * reach), windowRight = clampX(changed.left + changed.width + 2 * reach);
+        long windowY = clampY(changed.top - 2 * reach), windowBottom = clampY(changed.top + changed.height + 2 * reach);
+        long windowWidth = windowRight - windowX, windowHeight = windowBottom - windowY;
+        if (outLeft >= outRight || outTop >= outBottom) return;
+
+        window.resize(static_cast<size_t>(windowWidth * windowHeight));
+        transformColumns(tileMap, windowX, windowY, windowWidth, windowHeight, 0, windowWidth, window.data());
+        for (long y = outTop; y < outBottom; ++y) {
+            transformRow(windowX, windowWidth, &window[(y - windowY) * windowWidth], &distances[y * mapWidth + windowX], outLeft - windowX, outRight - windowX, rowScratch);
+        }
+    }
+
+    void DistanceField::transformColumns(const TileMap& tileMap, long windowX, long windowY, long windowWidth, long windowHeight, long x0, long x1, uint8_t* out) const {
+        // distance to the nearest wall above or below in the same column, capped one past maxDistance. the rows just outside
+        // the map are walls; walls outside a window that doesn't touch the map edge are too far away to matter
+        const int far = maxDistance + 1;
+        for (long y = 0; y < windowHeight; ++y) {
+            uint8_t* row = out + y * windowWidth;
+            const uint8_t* above = y > 0 ? row - windowWidth : nullptr;
+            int aboveEdge = windowY + y == 0 ? 0 : far;
+            for (long x = x0; x < x1; ++x) {
+                bool walkable = tileMap.isWalkable(static_cast<size_t>(windowX + x), static_cast<size_t>(windowY + y));
+                row[x] = static_cast<uint8_t>(walkable ? std::min(far, (above ? above[x] : aboveEdge) + 1) : 0);
+            }
+        }
+        for (long y = windowHeight - 1; y >= 0; --y) {
+            uint8_t* row = out + y * windowWidth;
+            const uint8_t* below = y + 1 < windowHeight ? row + windowWidth : nullptr;
+            int belowEdge = windowY + y + 1 == static_cast<long>(height) ? 0 : far;
+            for (long x = x0; x < x1; ++x) {
+                if (row[x]) row[x] = static_cast<uint8_t>(std::min<int>(row[x], (below ? below[x] : belowEdge) + 1));
+            }
+        }
+    }
+
+    void DistanceField::transformRow(long windowX, long windowWidth, const uint8_t* vertical, uint8_t* out, long outX0, long outX1, std::vector<int>& scratch) const {
+        /* Meijster's second phase for the chessboard metric: the distance at x is the lowest max(|x - i|, g(i)) over the
+        row, found by keeping the columns whose cone is lowest somewhere (s) and where each one starts to win (t) */
+        scratch.resize(static_cast<size_t>(windowWidth) * 3);
+        int* g = scratch.data();
+        int* s = g + windowWidth;
+        int* t = s + windowWidth;
+        for (long i = 0; i < windowWidth; ++i) g[i] = vertical[i]; // out may be the same row
+
+        auto f = [&](long x, long i) { return std::max<long>(std::abs(x - i), g[i]); };
+        auto separation = [&](long i, long u) { // first x where u's cone is no higher than i's, minus one
+            return g[i] <= g[u] ? std::max<long>(i + g[u], (i + u) / 2) : std::min<long>(u - g[i], (i + u) / 2);
+        };
+
+        long q = 0;
+        s[0] = 0;
+        t[0] = 0;
+        for (long u = 1; u < windowWidth; ++u) {
+            while (q >= 0 && f(t[q], s[q]) > f(t[q], u)) --q;
+            if (q < 0) {
+                q = 0;
+                s[0] = static_cast<int>(u);
+            } else {
+                long w = 1 + separation(s[q], u);
+                if (w < windowWidth) {
+                    ++q;
+                    s[q] = static_cast<int>(u);
+                    t[q] = static_cast<int>(w);
+                }
+            }
+        }
+
+        // the columns just left and right of the map are walls too
+        long mapWidth = static_cast<long>(width);
+        for (long u = windowWidth - 1; u >= 0; --u) {
+            long distance = f(u, s[q]);
+            if (u == t[q]) --q;
+            if (u < outX0 || u >= outX1) continue;
+            long mapX = windowX + u;
+            distance = std::min({ distance, mapX + 1, mapWidth - mapX, static_cast<long>(maxDistance) });
+            out[u] = static_cast<uint8_t>(distance);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+//
+//  distancefield.hpp
+//
+//
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+
+#include "../../test-assets/tiles/tiles.hpp"
+#include "../core/jobs.hpp"
+
+namespace physics {
+    /* per-cell chessboard (Chebyshev) distance from every tile to the nearest non-walkable tile, with the map's outside
+    counting as wall: a cell holding d has only walkable cells within d - 1 tiles on both axes, so a ray can cross that
+    square in one step. distances are capped at maxDistance and kept in one byte per cell of the whole map.
+    sync follows the tile map's walkability log: a new map (or a log that lost track) is rebuilt on every thread with a
+    separable transform (columns, then rows), edits only recompute the cells within maxDistance of the changed rects */
+    class DistanceField {
+    public:
+        static constexpr uint8_t maxDistance = 64; // also how far an edit reaches
+
+        void sync(const TileMap& tileMap, JobSystem* jobSystem = nullptr);
+        bool isSyncedWith(const TileMap& tileMap) const { return mapId == tileMap.getMapId() && version == tileMap.getWalkableVersion(); }
+
+        uint8_t getDistance(size_t x, size_t y) const { return distances[y * width + x]; } // unchecked, the map's coordinates
+        size_t getWidth() const { return width; }
+        size_t getHeight() const { return height; }
+
+    private:
+        void rebuild(const TileMap& tileMap, JobSystem* jobSystem);
+        void rebuildRegion(const TileMap& tileMap, const sf::IntRect& changed);
+
+        // vertical distances of the columns [x0, x1) of a window, then the window's rows are turned into the final field
+        void transformColumns(const TileMap& tileMap, long windowX, long windowY, long windowWidth, long windowHeight, long x0, long x1, uint8_t* out) const;
+        void transformRow(long windowX, long windowWidth, const uint8_t* vertical, uint8_t* out, long outX0, long outX1, std::vector<int>& scratch) const;
+
+        uint64_t mapId {};
+        uint64_t version {};
+        size_t width {};
+        size_t height {};
+        std::vector<uint8_t> distances;
+
+        std::vector<uint8_t> window; // rebuildRegion's vertical pass, reused
+        std::vector<int> rowScratch;
+        std::vector<sf::IntRect> changes;
+    };
+
+    extern DistanceField cachedDistanceField; // the raycaster's, synced at the start of every distance-field frame
+}
@@ -0,0 +1,239 @@
+//
+//  loosequadtree.cpp
+//
+//
+
+#include "loosequadtree.hpp"
+
+#include <algorithm>
+
+namespace physics {
+    LooseQuadtree::LooseQuadtree(float x, float y, float width, float height, size_t maxObjects, size_t maxLevels)
+        : maxObjects(std::max<size_t>(maxObjects, 2)), maxLevels(maxLevels) {
+        nodes.emplace_back();
+        nodes[0].bounds = sf::FloatRect(x, y, width, height);
+    }
+
+    sf::FloatRect LooseQuadtree::looseBounds(const Node& node) {
+        const sf::FloatRect& tight = node.bounds;
+        return { tight.left - tight.width / 2.0f, tight.top - tight.height / 2.0f, tight.width * 2.0f, tight.height * 2.0f };
+    }
+
+    bool LooseQuadtree::fits(const Node& node, const sf::FloatRect& bounds) const {
+        if (node.parent == noNode) return true; // the root also takes whatever is outside the world
+        if (bounds.width > node.bounds.width || bounds.height > node.bounds.height) return false;
+        sf::FloatRect loose = looseBounds(node);
+        return bounds.left >= loose.left && bounds.top >= loose.top &&
+               bounds.left + bounds.width <= loose.left + loose.width && bounds.top + bounds.height <= loose.top + loose.height;
+    }
+
+    uint32_t LooseQuadtree::childFor(const Node& node, const sf::FloatRect& bounds) const {
+        float centerX = bounds.left + bounds.width / 2.0f, centerY = bounds.top + bounds.height / 2.0f;
+        float middleX = node.bounds.left + node.bounds.width / 2.0f, middleY = node.bounds.top + node.bounds.height / 2.0f;
+        return node.firstChild + (centerY >= middleY ? 2 : 0) + (centerX >= middleX ? 1 : 0);
+    }
+
+    LooseQuadtree::Handle LooseQuadtree::insertHandle(Sprite* sprite) {
+        if (!sprite) {
+            log_warning("Tried to insert a null sprite into the loose quadtree");
+            return invalidHandle;
+        }
+
+        Handle handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        } else {
+            handle = static_cast<Handle>(entries.size());
+            entries.emplace_back();
+        }
+        entries[handle].sprite = sprite;
+        entries[handle].bounds = sprite->returnSpritesShape().getGlobalBounds();
+        ++spriteCount;
+        place(handle, 0);
+        return handle;
+    }
+
+    void LooseQuadtree::remove(Sprite* sprite) {
+        auto found = std::find_if(entries.begin(), entries.end(), [sprite](const Entry& entry) { return entry.sprite == sprite; });
+        if (found != entries.end()) remove(static_cast<Handle>(found - entries.begin()));
+    }
+
+    void LooseQuadtree::remove(Handle handle) {
+        if (handle >= entries.size() || !entries[handle].sprite) return;
+
+        uint32_t node = entries[handle].node;
+        detach(handle);
+        entries[handle] = Entry();
+        freeHandles.push_back(handle);
+        --spriteCount;
+        mergeUpFrom(node);
+    }
+
+    void LooseQuadtree::clear() {
+        nodes.resize(1);
+        nodes[0].firstChild = noNode;
+        nodes[0].subtreeCount = 0;
+        nodes[0].entries.clear();
+        freeNodes.clear();
+        entries.clear();
+        freeHandles.clear();
+        spriteCount = 0;
+    }
+
+    void LooseQuadtree::update() {
+        try {
+            relocations = 0;
+            for (Handle handle = 0; handle < entries.size(); ++handle) {
+                Entry& entry = entries[handle];
+                if (!entry.sprite) continue;
+                entry.bounds = entry.sprite->returnSpritesShape().getGlobalBounds();
+                if (fits(nodes[entry.node], entry.bounds)) continue; // still inside its node's loose bounds, nothing to move
+
+                // up to the nearest ancestor that can hold it, down from there; merges wait until it has landed so the ancestor survives
+                uint32_t oldNode = entry.node;
+                detach(handle);
+                uint32_t start = nodes[oldNode].parent;
+                while (!fits(nodes[start], entry.bounds)) start = nodes[start].parent;
+                place(handle, start);
+                mergeUpFrom(oldNode);
+                ++relocations;
+            }
+        } catch (const std::exception& e) {
+            log_error("Error during loose quadtree update: " + std::string(e.what()));
+        }
+    }
+
+    void LooseQuadtree::place(Handle handle, uint32_t start) {
+        const sf::FloatRect& bounds = entries[handle].bounds;
+        uint32_t node = start;
+        while (nodes[node].firstChild != noNode) {
+            uint32_t child = childFor(nodes[node], bounds);
+            if (!fits(nodes[child], bounds)) break;
+            node = child;
+        }
+        attach(handle, node);
+        if (nodes[node].firstChild == noNode && nodes[node].entries.size() > maxObjects && nodes[node].level < maxLevels) split(node);
+    }
+
+    void LooseQuadtree::attach(Handle handle, uint32_t node) {
+        Entry& entry = entries[handle];
+        entry.node = node;
+        entry.slot = static_cast<uint32_t>(nodes[node].entries.size());
+        nodes[node].entries.push_back(handle);
+        for (uint32_t n = node; n != noNode; n = nodes[n].parent) ++nodes[n].subtreeCount;
+    }
+
+    void LooseQuadtree::detach(Handle handle) {
+        Entry& entry = entries[handle];
+        std::vector<Handle>& held = nodes[entry.node].entries;
+        Handle last = held.back();
+        held[entry.slot] = last; // the last sprite takes the freed slot
+        entries[last].slot = entry.slot;
+        held.pop_back();
+        for (uint32_t n = entry.node; n != noNode; n = nodes[n].parent) --nodes[n].subtreeCount;
+        entry.node = noNode;
+    }
+
+    void LooseQuadtree::split(uint32_t node) {
+        uint32_t first;
+        if (!freeNodes.empty()) {
+            first = freeNodes.back();
+            freeNodes.pop_back();
+        } else {
+            first = static_cast<uint32_t>(nodes.size());
+            nodes.resize(nodes.size() + 4); // may move the nodes, no references are held across this
+        }
+
+        const sf::FloatRect bounds = nodes[node].bounds;
+        float halfWidth = bounds.width / 2.0f, halfHeight = bounds.height / 2.0f;
+        for (uint32_t child = 0; child < 4; ++child) {
+            Node& created = nodes[first + child];
+            created.bounds = sf::FloatRect(bounds.left + (child & 1) * halfWidth, bounds.top + (child >> 1) * halfHeight, halfWidth, halfHeight);
+            created.parent = node;
+            created.firstChild = noNode;
+            created.level = nodes[node].level + 1;
+            created.subtreeCount = 0;
+            created.entries.clear();
+        }
+        nodes[node].firstChild = first;
+
+        // from the back, so the sprite detach swaps into a slot was already looked at
+        for (size_t i = nodes[node].entries.size(); i-- > 0;) {
+            Handle handle = nodes[node].entries[i];
+            uint32_t child = childFor(nodes[node], entries[handle].bounds);
+            if (!fits(nodes[child], entries[handle].bounds)) continue;
+            detach(handle);
+            attach(handle, child);
+        }
+        for (uint32_t child = first; child < first + 4; ++child) {
+            if (nodes[child].entries.size() > maxObjects && nodes[child].level < maxLevels) split(child);
+        }
+    }
+
+    void LooseQuadtree::mergeUpFrom(uint32_t node) {
+        // subtree counts only grow going up, so the ancestors that are small enough are a run starting at the parent
+        uint32_t target = noNode;
+        for (uint32_t n = nodes[node].parent; n != noNode && nodes[n].subtreeCount <= maxObjects / 2; n = nodes[n].parent) target = n;
+        if (target == noNode) return;
+        collectSubtree(target, target);
+    }
+
+    void LooseQuadtree::collectSubtree(uint32_t node, uint32_t into) {
+        uint32_t first = nodes[node].firstChild;
+        if (first == noNode) return;
+        for (uint32_t child = first; child < first + 4; ++child) {
+            collectSubtree(child, into);
+            for (Handle handle : nodes[child].entries) {
+                entries[handle].node = into;
+                entries[handle].slot = static_cast<uint32_t>(nodes[into].entries.size());
+                nodes[into].entries.push_back(handle);
+            }
+            nodes[child].entries.clear();
+            nodes[child].subtreeCount = 0;
+        }
+        nodes[node].firstChild = noNode;
+        freeNodes.push_back(first);
+    }
+
+    template<typename Test>
+    void LooseQuadtree::queryNode(uint32_t node, const Test& test, std::vector<Sprite*>& result) const {
+        const Node& current = nodes[node];
+        if (current.subtreeCount == 0) return;
+        if (current.parent != noNode && !test(looseBounds(current))) return; // the root also holds sprites outside the world
+
+        for (Handle handle : current.entries) {
+            if (test(entries[handle].bounds)) result.push_back(entries[handle].sprite);
+        }
+        if (current.firstChild == noNode) return;
+        for (uint32_t child = current.firstChild; child < current.firstChild + 4; ++child) queryNode(child, test, result);
+    }
+
+    void LooseQuadtree::query(const sf::FloatRect& area, std::vector<Sprite*>& result) const {
+        queryNode(0, [&area](const sf::FloatRect& rect) { return area.intersects(rect); }, result);
+    }
+
+    void LooseQuadtree::queryFrustum(const ViewFrustum& frustum, std::vector<Sprite*>& result) const {
+        queryNode(0, [&frustum](const sf::FloatRect& rect) { return frustum.intersects(rect); }, result);
+    }
+
+    void LooseQuadtree::findPairs(std::vector<std::pair<Sprite*, Sprite*>>& pairs) const {
+        // loose bounds of neighbours overlap, so every sprite searches the tree; the lower handle of a pair reports it
+        for (Handle handle = 0; handle < entries.size(); ++handle) {
+            if (entries[handle].sprite) findPairs(0, handle, pairs);
+        }
+    }
+
+    void LooseQuadtree::findPairs(uint32_t node, Handle handle, std::vector<std::pair<Sprite*, Sprite*>>& pairs) const {
+        const Node& current = nodes[node];
+        const Entry& entry = entries[handle];
+        if (current.subtreeCount == 0) return;
+        if (current.parent != noNode && !entry.bounds.intersects(looseBounds(current))) return;
+
+        for (Handle other : current.entries) {
+            if (other > handle && entry.bounds.intersects(entries[other].bounds)) pairs.emplace_back(entry.sprite, entries[other].sprite);
+        }
+        if (current.firstChild == noNode) return;
+        for (uint32_t child = current.firstChild; child < current.firstChild + 4; ++child) findPairs(child, handle, pairs);
+    }
+}
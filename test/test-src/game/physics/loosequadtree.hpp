@@ -0,0 +1,86 @@
+//
+//  loosequadtree.hpp
+//
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "broadphase.hpp"
+
+namespace physics {
+    /* quadtree whose nodes accept sprites out to twice their size (half a node past every edge), so a sprite is held by the
+    node containing its centre on the deepest level it is no larger than. A sprite that moved is only relocated once its
+    bounds leave that node's loose bounds or stop fitting it, which for small steps is rarely: most frames update() only
+    refreshes the stored bounds. Nodes live in one pool with a free list and are addressed by index; every sprite keeps
+    a handle with its node and its slot in that node, so removal swaps the node's last sprite into the slot in O(1).
+    A leaf splits when it holds more than maxObjects (until maxLevels), children are merged back once their subtree is
+    down to half of maxObjects, the gap keeps a node from splitting and merging every frame */
+    class LooseQuadtree : public Broadphase {
+    public:
+        using Handle = uint32_t;
+        static constexpr Handle invalidHandle = 0xFFFFFFFF;
+
+        LooseQuadtree(float x, float y, float width, float height, size_t maxObjects = 8, size_t maxLevels = 8);
+
+        using Broadphase::insert;
+        void insert(Sprite* sprite) override { insertHandle(sprite); }
+        Handle insertHandle(Sprite* sprite); // the handle stays valid until the sprite is removed
+        void remove(Sprite* sprite) override; // looks the handle up, O(n)
+        void remove(Handle handle);
+        void clear() override;
+        void update() override; // relocates the sprites that left their node's loose bounds
+
+        void query(const sf::FloatRect& area, std::vector<Sprite*>& result) const override;
+        void queryFrustum(const ViewFrustum& frustum, std::vector<Sprite*>& result) const override;
+        void findPairs(std::vector<std::pair<Sprite*, Sprite*>>& pairs) const override;
+        size_t getSpriteCount() const override { return spriteCount; }
+
+        size_t getNodeCount() const { return nodes.size() - freeNodes.size() * 4; } // nodes in use
+        size_t getRelocationCount() const { return relocations; } // sprites moved to another node by the last update
+
+    private:
+        static constexpr uint32_t noNode = 0xFFFFFFFF;
+
+        struct Node {
+            sf::FloatRect bounds; // tight; the loose bounds reach half a node further on every side
+            uint32_t parent = noNode;
+            uint32_t firstChild = noNode; // children are 4 consecutive nodes
+            uint32_t level {};
+            uint32_t subtreeCount {}; // sprites in this node and below
+            std::vector<Handle> entries; // sprites held by this node, keeps its capacity when the node is reused
+        };
+
+        struct Entry {
+            Sprite* sprite = nullptr; // null while the handle is free
+            sf::FloatRect bounds; // as of the last update
+            uint32_t node = noNode;
+            uint32_t slot {}; // index in the node's entries
+        };
+
+        static sf::FloatRect looseBounds(const Node& node);
+        bool fits(const Node& node, const sf::FloatRect& bounds) const; // the node may hold a sprite with these bounds
+        uint32_t childFor(const Node& node, const sf::FloatRect& bounds) const; // the child whose quarter holds the centre
+        void place(Handle handle, uint32_t start); // from start down to the deepest node that fits
+        void attach(Handle handle, uint32_t node);
+        void detach(Handle handle);
+        void split(uint32_t node);
+        void mergeUpFrom(uint32_t node); // merges the highest ancestor whose subtree became small enough
+        void collectSubtree(uint32_t node, uint32_t into);
+        template<typename Test> void queryNode(uint32_t node, const Test& test, std::vector<Sprite*>& result) const;
+        void findPairs(uint32_t node, Handle handle, std::vector<std::pair<Sprite*, Sprite*>>& pairs) const; // handle against the subtree
+
+        size_t maxObjects;
+        size_t maxLevels;
+        size_t spriteCount {};
+        size_t relocations {};
+
+        std::vector<Node> nodes; // nodes[0] is the root
+        std::vector<uint32_t> freeNodes; // first index of every free group of 4 children
+        std::vector<Entry> entries; // indexed by handle
+        std::vector<Handle> freeHandles;
+    };
+}
@@ -1,123 +1,124 @@
 #include "physics.hpp"
+#include "bucketsort.hpp"
+
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #include <immintrin.h>
+    #define BITMASK_TARGET_AVX2 __attribute__((target("avx2")))
+    #define BITMASK_HAS_AVX2 1
+#else
+    #define BITMASK_HAS_AVX2 0
+#endif
 
 // physics namespace to have sprites move 
 namespace physics {
-    Quadtree::Quadtree(float x, float y, float width, float height, size_t level, size_t maxObjects, size_t maxLevels)
-        : maxObjects(maxObjects), maxLevels(maxLevels), level(level), bounds(x, y, width, height) {}
+    Quadtree::Quadtree(float x, float y, float width, float height, size_t maxLevels)
+        : bounds(x, y, width, height), maxLevels(std::min<size_t>(maxLevels, 10)) {
+        // a complete tree: a subtree rooted at level l has (4^(maxLevels - l + 1) - 1) / 3 nodes
+        subtreeSizes.resize(this->maxLevels + 2, 0);
+        for (size_t level = this->maxLevels + 1; level-- > 0;) subtreeSizes[level] = 1 + 4 * subtreeSizes[level + 1];
+        nodeCount = subtreeSizes[0];
+        nodeStarts.assign(nodeCount + 1, 0);
+        log_info("Quadtree with " + std::to_string(nodeCount) + " nodes over " + std::to_string(this->maxLevels + 1) + " levels");
+    }
 
     void Quadtree::clear() {
-        objects.clear();
-        log_info("objects cleared.");
-        nodes.clear();
-        log_info("Quadtree cleared.");
+        sprites.clear();
+        items.clear();
+        std::fill(nodeStarts.begin(), nodeStarts.end(), 0);
     }
 
-    std::vector<Sprite*> Quadtree::query(const sf::FloatRect& area) const {
-        try {
-            std::vector<Sprite*> result;
-            if (!bounds.intersects(area)) {
-                log_warning("Area does not intersect with the quadtree bounds at level " + std::to_string(level));
-                return result;
-            }
-
-            for (const auto& obj : objects) {
-                if (area.intersects(obj->returnSpritesShape().getGlobalBounds())) {
-                    result.push_back(obj);
-                    log_info("Sprite added to query result at level " + std::to_string(level));
-                }
-            }
+    void Quadtree::insert(Sprite* sprite) {
+        if (!sprite) {
+            log_warning("Tried to insert a null sprite into the quadtree");
+            return;
+        }
+        sprites.push_back(sprite);
+    }
 
-            for (const auto& node : nodes) {
-                auto nodeResult = node->query(area);
-                result.insert(result.end(), nodeResult.begin(), nodeResult.end());
-            }
-            return result;
+    void Quadtree::remove(Sprite* sprite) {
+        removeFromBuckets(sprite, sprites, nodeStarts, items);
+    }
 
-        } catch (const std::exception& e) {
-            log_error("Error during query at level " + std::to_string(level) + ": " + std::string(e.what()));
-            return std::vector<Sprite*>();
+    size_t Quadtree::nodeIndex(const sf::FloatRect& itemBounds) const {
+        if (itemBounds.left < bounds.left || itemBounds.top < bounds.top || itemBounds.left + itemBounds.width > bounds.left + bounds.width ||
+            itemBounds.top + itemBounds.height > bounds.top + bounds.height || bounds.width <= 0.0f || bounds.height <= 0.0f) return 0;
+
+        // cells of the two corners on the deepest level; the bits they share are the path down to the node holding both
+        size_t cells = size_t(1) << maxLevels;
+        auto cell = [cells](float offset, float size) { return std::min(cells - 1, static_cast<size_t>(offset / size * cells)); };
+        size_t minX = cell(itemBounds.left - bounds.left, bounds.width), maxX = cell(itemBounds.left + itemBounds.width - bounds.left, bounds.width);
+        size_t minY = cell(itemBounds.top - bounds.top, bounds.height), maxY = cell(itemBounds.top + itemBounds.height - bounds.top, bounds.height);
+
+        size_t node = 0;
+        for (size_t level = 1; level <= maxLevels; ++level) {
+            size_t shift = maxLevels - level;
+            if ((minX >> shift) != (maxX >> shift) || (minY >> shift) != (maxY >> shift)) break;
+            size_t child = ((minY >> shift) & 1) * 2 + ((minX >> shift) & 1);
+            node += 1 + child * subtreeSizes[level];
         }
+        return node;
     }
 
-    bool Quadtree::contains(const sf::FloatRect& bounds) const {
+    sf::FloatRect Quadtree::nodeBounds(size_t level, size_t x, size_t y) const {
+        float scale = 1.0f / static_cast<float>(size_t(1) << level);
+        return { bounds.left + bounds.width * scale * x, bounds.top + bounds.height * scale * y, bounds.width * scale, bounds.height * scale };
+    }
+
+    void Quadtree::update() {
         try {
-            bool result = this->bounds.contains(bounds.left, bounds.top) && this->bounds.contains(bounds.left + bounds.width, bounds.top + bounds.height);
-            log_info(result ? "Bounds are contained in the quadtree at level " + std::to_string(level) :
-                            "Bounds are not contained in the quadtree at level " + std::to_string(level));
-            return result;
+            // every sprite under the deepest node holding its bounds
+            itemNodes.resize(sprites.size());
+            itemBounds.resize(sprites.size());
+            for (size_t i = 0; i < sprites.size(); ++i) {
+                itemBounds[i] = sprites[i]->returnSpritesShape().getGlobalBounds();
+                itemNodes[i] = static_cast<uint32_t>(nodeIndex(itemBounds[i]));
+            }
+            sortByBucket(itemNodes, nodeCount, [this](size_t i) { return Item { sprites[i], itemBounds[i] }; }, nodeStarts, items);
         } catch (const std::exception& e) {
-            log_error("Error during contains check at level " + std::to_string(level) + ": " + std::string(e.what()));
-            return false;
+            log_error("Error during quadtree update: " + std::string(e.what()));
         }
     }
 
-    void Quadtree::subdivide() {
-        try {
-            // Check if we've reached the max level
-            if (level >= maxLevels) {
-                log_info("Maximum level reached, cannot subdivide further.");
-                return;
-            }
+    template<typename Test>
+    void Quadtree::queryNode(size_t node, size_t level, size_t x, size_t y, const Test& test, std::vector<Sprite*>& result) const {
+        size_t subtreeEnd = node + subtreeSizes[level];
+        if (nodeStarts[node] == nodeStarts[subtreeEnd]) return; // nothing in the whole subtree
+        if (level > 0 && !test(nodeBounds(level, x, y))) return; // the root also holds sprites outside the world
 
-            float halfWidth = bounds.width / 2;
-            float halfHeight = bounds.height / 2;
-            float x = bounds.left;
-            float y = bounds.top;
-
-            // Create four child nodes with smaller bounds and increment the level
-            nodes.push_back(std::make_unique<Quadtree>(x, y, halfWidth, halfHeight, level + 1, maxObjects, maxLevels));
-            nodes.push_back(std::make_unique<Quadtree>(x + halfWidth, y, halfWidth, halfHeight, level + 1, maxObjects, maxLevels));
-            nodes.push_back(std::make_unique<Quadtree>(x, y + halfHeight, halfWidth, halfHeight, level + 1, maxObjects, maxLevels));
-            nodes.push_back(std::make_unique<Quadtree>(x + halfWidth, y + halfHeight, halfWidth, halfHeight, level + 1, maxObjects, maxLevels));
-
-            log_info("Quadtree subdivided into 4 child nodes at level " + std::to_string(level));
-
-            // Redistribute the objects into the appropriate child nodes
-            for (auto it = objects.begin(); it != objects.end(); ) {
-                bool inserted = false;
-                for (auto& node : nodes) {
-                    if (node->bounds.intersects((*it)->returnSpritesShape().getGlobalBounds())) {
-                        node->objects.push_back(*it);
-                        it = objects.erase(it); // Remove object from the current node
-                        inserted = true;
-                        log_info("Sprite moved to child node at level " + std::to_string(node->level));
-                        break;
-                    }
-                }
-                if (!inserted) {
-                    ++it;
-                }
-            }
-        } catch (const std::exception& e) {
-            log_error("Error during subdivision at level " + std::to_string(level) + ": " + std::string(e.what()));
+        for (uint32_t i = nodeStarts[node]; i < nodeStarts[node + 1]; ++i) {
+            if (test(items[i].bounds)) result.push_back(items[i].sprite);
+        }
+        if (level == maxLevels) return;
+        for (size_t child = 0; child < 4; ++child) {
+            queryNode(node + 1 + child * subtreeSizes[level + 1], level + 1, x * 2 + (child & 1), y * 2 + (child >> 1), test, result);
         }
     }
 
-    void Quadtree::update() {
-        try {
-            for (auto& sprite : objects) {
-              //  log_info("Updating quadtree at level " + std::to_string(level));
-
-                if (sprite->getMoveState()) {
-                    // Check which node the sprite was in
-                    for (auto& node : nodes) {
-                        if (node->contains(sprite->returnSpritesShape().getGlobalBounds())) {
-                            // Remove sprite from the old node
-                            node->objects.erase(std::remove(node->objects.begin(), node->objects.end(), sprite), node->objects.end());
-                            log_info("Sprite removed from old node at level " + std::to_string(node->level));
-                            break;
-                        }
-                    }
-
-                    // Insert the sprite back into the quadtree
-                    std::unique_ptr<Sprite> spritePtr(sprite);
-                    insert(spritePtr);
-                    log_info("Sprite updated and inserted into quadtree at level " + std::to_string(level));
-                }
+    void Quadtree::query(const sf::FloatRect& area, std::vector<Sprite*>& result) const {
+        if (items.empty()) return;
+        queryNode(0, 0, 0, 0, [&area](const sf::FloatRect& rect) { return area.intersects(rect); }, result);
+    }
+
+    void Quadtree::queryFrustum(const ViewFrustum& frustum, std::vector<Sprite*>& result) const {
+        if (items.empty()) return;
+        queryNode(0, 0, 0, 0, [&frustum](const sf::FloatRect& rect) { return frustum.intersects(rect); }, result);
+    }
+
+    void Quadtree::findPairs(std::vector<std::pair<Sprite*, Sprite*>>& pairs) const {
+        if (!items.empty()) findPairs(0, 0, pairs);
+    }
+
+    void Quadtree::findPairs(size_t node, size_t level, std::vector<std::pair<Sprite*, Sprite*>>& pairs) const {
+        // sprites lie inside their node, so one can only overlap sprites of its own node and below, which follow it in items
+        uint32_t subtreeEnd = nodeStarts[node + subtreeSizes[level]];
+        if (nodeStarts[node] == subtreeEnd) return;
+        for (uint32_t i = nodeStarts[node]; i < nodeStarts[node + 1]; ++i) {
+            for (uint32_t j = i + 1; j < subtreeEnd; ++j) {
+                if (items[i].bounds.intersects(items[j].bounds)) pairs.emplace_back(items[i].sprite, items[j].sprite);
             }
-        } catch (const std::exception& e) {
-            log_error("Error during update at level " + std::to_string(level) + ": " + std::string(e.what()));
         }
+        if (level == maxLevels) return;
+        for (size_t child = 0; child < 4; ++child) findPairs(node + 1 + child * subtreeSizes[level + 1], level + 1, pairs);
     }
 
     // struct to hold raycast operation results that use vector of sprites
@@ -201,96 +202,6 @@ namespace physics {
         return originalPos;
     }
 
-    void calculateRayCast3d(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& tileMap, sf::VertexArray& lines, sf::VertexArray& wallLine) {
-        if(!player || !tileMap){
-            log_error("tile or player is not initialized");
-            return;
-        }
-
-        float startX = player->getSpritePos().x;
-        float startY = player->getSpritePos().y;
-        float playerAngle = player->getHeadingAngle(); // Player's rotation angle
-
-        size_t itCount = Constants::RAYS_NUM / 2;
-        float screenWidth = static_cast<float>(MetaComponents::bigView.getSize().x);
-        float screenHeight = static_cast<float>(MetaComponents::bigView.getSize().y);
-        float centerY = screenHeight / 2.0f;
-
-        const float wallHeightScale = 2500.0f;  // Scale factor for wall height
-        float angleStep = Constants::FOV / static_cast<float>(itCount);  // Angle step between rays
-        const float maxRayDistance = 1000.0f; // Maximum allowed ray distance to prevent infinite loops
-
-        wallLine.clear();
-        wallLine.setPrimitiveType(sf::Quads);  // Use quads for filled walls
-        lines.clear();
-        lines.setPrimitiveType(sf::Lines);
-        lines.resize(2 * itCount); // Ensure enough space for ray visualization
-
-        float sliceWidth = screenWidth / static_cast<float>(itCount); // Corrected wall slice width
-
-        for (size_t i = 0; i < itCount; ++i) {
-            float angleOffset = (i - itCount / 2.0f) * angleStep;
-            float rayAngle = playerAngle + angleOffset;
-            float radian = rayAngle * 3.14159f / 180.0f; // Convert to radians
-
-            float dirX = cos(radian);
-            float dirY = sin(radian);
-            float stepSize = 1.0f;
-
-            float rayX = startX;
-            float rayY = startY;
-            bool hit = false;
-            float rayDistance = 0.0f;
-
-            while (!hit && rayDistance < maxRayDistance) {
-                rayX += dirX * stepSize;
-                rayY += dirY * stepSize;
-                rayDistance += stepSize;
-
-                int tileX = static_cast<int>(rayX) / Constants::TILE_WIDTH;
-                int tileY = static_cast<int>(rayY) / Constants::TILE_HEIGHT;
-
-                if (tileX < 0 || tileY < 0 || tileX >= tileMap->getTileMapWidth() || tileY >= tileMap->getTileMapHeight()) break; // Exit if ray goes out of bounds
-            
-                // Store raycasting lines for debugging (2D representation)
-                lines[2 * i].position = sf::Vector2f(startX, startY);
-                lines[2 * i + 1].position = sf::Vector2f(rayX, rayY);
-                lines[2 * i].color = sf::Color::Red;
-                lines[2 * i + 1].color = sf::Color::Red;
-
-                auto& tile = tileMap->getTile(tileY * tileMap->getTileMapWidth() + tileX);
-
-                if (!tile->getWalkable()) { hit = true;
-
-                // Correct fish-eye effect
-                float correctedDistance = rayDistance * cos((rayAngle - playerAngle) * 3.14159f / 180.0f);
-                correctedDistance = std::max(1.0f, correctedDistance); // Prevent division by zero or extreme values
-
-                // Compute projected wall height
-                float wallHeight = wallHeightScale / correctedDistance;
-
-                // Compute screen position for this wall slice
-                float screenX = i * sliceWidth;
-                float wallTopY = centerY - wallHeight / 2.0f;
-                float wallBottomY = centerY + wallHeight / 2.0f;
-
-                // Adjust brightness based on distance
-                const float maxDistance = 100.0f; // Adjust based on game scale
-                float brightnessFactor = std::max(0.2f, 1.0f - (correctedDistance / maxDistance));
-                sf::Uint8 color = static_cast<sf::Uint8>(50 + 150 * brightnessFactor);
-               // sf::Color wallColor(0, static_cast<sf::Uint8>(50 + 150 * brightnessFactor), 0);
-                sf::Color wallColor(color, color, color);
-
-                // Define quad vertices for the wall slice
-                wallLine.append(sf::Vertex(sf::Vector2f(screenX, wallTopY), wallColor));     // Top Left
-                wallLine.append(sf::Vertex(sf::Vector2f(screenX + sliceWidth, wallTopY), wallColor));   // Top Right
-                wallLine.append(sf::Vertex(sf::Vector2f(screenX + sliceWidth, wallBottomY), wallColor)); // Bottom Right
-                wallLine.append(sf::Vertex(sf::Vector2f(screenX, wallBottomY), wallColor));  // Bottom Left
-                }
-            }
-        }
-    }
-    
 // collisions 
     // circle collision 
     bool circleCollision(sf::Vector2f pos1, float radius1, sf::Vector2f pos2, float radius2) {
@@ -395,52 +306,95 @@ namespace physics {
         return !(xOverlapStart >= xOverlapEnd || yOverlapStart >= yOverlapEnd); 
     }
 
+    namespace {
+        // the 64 pixels of a bitmask row starting at pixel bit; the row's zero guard word covers reading past its last word
+        uint64_t bitmaskWord(const uint64_t* row, unsigned int bit) {
+            unsigned int word = bit / 64, shift = bit % 64;
+            return shift ? (row[word] >> shift) | (row[word + 1] << (64 - shift)) : row[word];
+        }
+
+#if BITMASK_HAS_AVX2
+        // blocks x 256 pixels of two rows at once, the same shift and combine on 4 words per lane; only called after detectRayKernel confirmed AVX2
+        BITMASK_TARGET_AVX2 bool rowsOverlapAVX2(const uint64_t* row1, unsigned int start1, const uint64_t* row2, unsigned int start2, size_t blocks) {
+            const uint64_t* words1 = row1 + start1 / 64;
+            const uint64_t* words2 = row2 + start2 / 64;
+            // a shift by 64 gives 0 in AVX2, so pixel aligned rows (shift 0) need no special case
+            __m128i right1 = _mm_cvtsi32_si128(static_cast<int>(start1 % 64)), left1 = _mm_cvtsi32_si128(static_cast<int>(64 - start1 % 64));
+            __m128i right2 = _mm_cvtsi32_si128(static_cast<int>(start2 % 64)), left2 = _mm_cvtsi32_si128(static_cast<int>(64 - start2 % 64));
+
+            for (size_t block = 0; block < blocks; ++block, words1 += 4, words2 += 4) {
+                __m256i a = _mm256_or_si256(_mm256_srl_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words1)), right1),
+                                            _mm256_sll_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words1 + 1)), left1));
+                __m256i b = _mm256_or_si256(_mm256_srl_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words2)), right2),
+                                            _mm256_sll_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words2 + 1)), left2));
+                if (!_mm256_testz_si256(a, b)) return true;
+            }
+            return false;
+        }
+#endif
+
+        // whether length pixels of row1 from start1 and of row2 from start2 share a set bit, a word at a time
+        bool rowsOverlap(const uint64_t* row1, unsigned int start1, const uint64_t* row2, unsigned int start2, unsigned int length, bool avx2) {
+            unsigned int words = length / 64, word = 0;
+#if BITMASK_HAS_AVX2
+            if (avx2 && words >= 4) {
+                if (rowsOverlapAVX2(row1, start1, row2, start2, words / 4)) return true;
+                word = words / 4 * 4;
+            }
+#endif
+            for (; word < words; ++word) {
+                if (bitmaskWord(row1, start1 + word * 64) & bitmaskWord(row2, start2 + word * 64)) return true;
+            }
+            unsigned int rest = length % 64;
+            if (!rest) return false;
+            uint64_t mask = (uint64_t(1) << rest) - 1;
+            return bitmaskWord(row1, start1 + words * 64) & bitmaskWord(row2, start2 + words * 64) & mask;
+        }
+    }
+
     bool pixelPerfectCollision( const std::shared_ptr<sf::Uint8[]>& bitmask1, const sf::Vector2f& position1, const sf::Vector2f& size1,
                                 const std::shared_ptr<sf::Uint8[]>& bitmask2, const sf::Vector2f& position2, const sf::Vector2f& size2) {
+        return pixelPerfectCollision(bitmask1, position1, size1, bitmask2, position2, size2, detectRayKernel());
+    }
 
-        // Helper function to get the pixel index in the bitmask
-        auto getPixelIndex = [](const sf::Vector2f& size, int x, int y) -> int {
-            return (y * static_cast<int>(size.x) + x) * 4; // Each pixel has 4 bytes (RGBA)
-        };
+    bool pixelPerfectCollision(const std::shared_ptr<sf::Uint8[]>& bitmask1, const sf::Vector2f& position1, const sf::Vector2f& size1,
+                               const std::shared_ptr<sf::Uint8[]>& bitmask2, const sf::Vector2f& position2, const sf::Vector2f& size2, RayKernel kernel) {
+        if (!bitmask1 || !bitmask2) return false;
 
-        // Calculate the overlapping area between the two objects
-        float left = std::max(position1.x, position2.x);
-        float top = std::max(position1.y, position2.y);
-        float right = std::min(position1.x + size1.x, position2.x + size2.x);
-        float bottom = std::min(position1.y + size1.y, position2.y + size2.y);
+        // pixel grid of both sprites, and the overlapping area on it
+        int x1 = static_cast<int>(position1.x), y1 = static_cast<int>(position1.y);
+        int x2 = static_cast<int>(position2.x), y2 = static_cast<int>(position2.y);
+        int width1 = static_cast<int>(size1.x), height1 = static_cast<int>(size1.y);
+        int width2 = static_cast<int>(size2.x), height2 = static_cast<int>(size2.y);
+        int left = std::max(x1, x2), right = std::min(x1 + width1, x2 + width2);
+        int top = std::max(y1, y2), bottom = std::min(y1 + height1, y2 + height2);
 
         // Check AABB collision first
         if (left >= right || top >= bottom) return false; 
-        //std::cout << "AABB collision passed." << std::endl;
-        // Check each pixel in the overlapping area
-        for (int y = static_cast<int>(top); y < static_cast<int>(bottom); ++y) {
-            for (int x = static_cast<int>(left); x < static_cast<int>(right); ++x) {
-                // Calculate the position in each bitmask
-                int x1 = x - static_cast<int>(position1.x);
-                int y1 = y - static_cast<int>(position1.y);
-                int x2 = x - static_cast<int>(position2.x);
-                int y2 = y - static_cast<int>(position2.y);
-
-                // Get the index of the pixel in each bitmask
-                int index1 = getPixelIndex(size1, x1, y1);
-                int index2 = getPixelIndex(size2, x2, y2);
 
-                // Check if the pixels' values are non-zero (i.e., not transparent)
-                if (bitmask1[index1] == 1 && bitmask2[index2] == 1) {
-                    return true; // Collision detected
-                }
-            }
+        // one AND per 64 pixels of a row instead of a test per pixel, so the cost follows the overlap's height; stops at the first shared pixel
+        const uint64_t* words1 = reinterpret_cast<const uint64_t*>(bitmask1.get());
+        const uint64_t* words2 = reinterpret_cast<const uint64_t*>(bitmask2.get());
+        size_t stride1 = Constants::bitmaskRowWords(width1), stride2 = Constants::bitmaskRowWords(width2);
+        bool avx2 = kernel == RayKernel::AVX2 && detectRayKernel() == RayKernel::AVX2;
+        for (int y = top; y < bottom; ++y) {
+            const uint64_t* row1 = words1 + (y - y1) * stride1;
+            const uint64_t* row2 = words2 + (y - y2) * stride2;
+            if (rowsOverlap(row1, left - x1, row2, left - x2, right - left, avx2)) return true; // Collision detected
         }
-        //std::cout << "Pixel perfect collision passed." << std::endl;
         return false; 
     }
     bool pixelPerfectCollision(const std::shared_ptr<sf::Uint8[]>& bitmask1, const sf::Vector2f& position1, const sf::Vector2f& size1,
         const std::shared_ptr<sf::Uint8[]>& bitmask2, const sf::Vector2f& position2, const sf::Vector2f& size2,
         float angle1, float angle2) {
 
-        // Helper function to get the pixel index in the bitmask
-        auto getPixelIndex = [](const sf::Vector2f& size, int x, int y) -> int {
-            return (y * static_cast<int>(size.x) + x) * 4; // Each pixel has 4 bytes (RGBA)
+        if (!bitmask1 || !bitmask2) return false;
+
+        // rotated pixels don't line up with the rows, so this one stays a test per pixel; outside the mask counts as clear
+        auto pixelSet = [](const std::shared_ptr<sf::Uint8[]>& bitmask, const sf::Vector2f& size, sf::Vector2f local) {
+            int x = static_cast<int>(local.x), y = static_cast<int>(local.y);
+            if (x < 0 || y < 0 || x >= static_cast<int>(size.x) || y >= static_cast<int>(size.y)) return false;
+            return Constants::bitmaskPixel(bitmask, static_cast<unsigned int>(size.x), x, y);
         };
 
         // Calculate the overlapping area between the two objects
@@ -454,7 +408,7 @@ namespace physics {
 
         // Helper function to rotate a point (x, y) around the center of the sprite
         auto rotatePoint = [](float x, float y, float angle) -> sf::Vector2f {
-            float rad = angle * 3.14159f / 180.0f;
+            float rad = angle * Constants::DEG_TO_RAD;
             float cosAngle = std::cos(rad);
             float sinAngle = std::sin(rad);
             return sf::Vector2f(x * cosAngle - y * sinAngle, x * sinAngle + y * cosAngle);
@@ -474,12 +428,8 @@ namespace physics {
                 auto rotated1 = rotatePoint(x1, y1, -angle1);
                 auto rotated2 = rotatePoint(x2, y2, -angle2);
 
-                // Get the index of the pixel in each bitmask
-                int index1 = getPixelIndex(size1, static_cast<int>(rotated1.x), static_cast<int>(rotated1.y));
-                int index2 = getPixelIndex(size2, static_cast<int>(rotated2.x), static_cast<int>(rotated2.y));
-
-                // Check if the pixels' values are non-zero (i.e., not transparent)
-                if (bitmask1[index1] == 1 && bitmask2[index2] == 1) {
+                // Check if the pixels are set in both bitmasks (i.e., not transparent)
+                if (pixelSet(bitmask1, size1, rotated1) && pixelSet(bitmask2, size2, rotated2)) {
                     return true; // Collision detected
                 }
             }
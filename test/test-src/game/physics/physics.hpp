@@ -9,54 +9,64 @@
 #include <math.h>
 #include <functional> 
 #include <utility>
+#include <algorithm>
+#include <cstdint>
 
 #include "../../test-assets/sprites/sprites.hpp" 
 #include "../../test-assets/tiles/tiles.hpp" 
+#include "raycast.hpp"
+#include "raypacket.hpp"
+#include "broadphase.hpp"
 
 
 namespace physics{
 
-    class Quadtree {
+    /* linear quadtree over a fixed world rect, rebuilt from scratch by update() every frame. The tree is complete down to
+    maxLevels and numbered in preorder, so nodes are just indices (a node's children and its whole subtree are computed,
+    not stored) and a subtree's sprites are one contiguous range of the sorted item array. update() puts every sprite in
+    the deepest node that fully contains its bounds (sprites sticking out of the world stay in the root) with a counting
+    sort by node: O(n + nodes), and no allocation once the buffers have grown to the sprite count.
+    sprites added with insert can be queried after the next update; queries append to the caller's vector */
+    class Quadtree : public Broadphase {
     public:
-        Quadtree(float x, float y, float width, float height, size_t level = 0, size_t maxObjects = 10, size_t maxLevels = 5);
-        ~Quadtree(){ clear(); };
+        Quadtree(float x, float y, float width, float height, size_t maxLevels = 5);
 
-        void clear();
+        void clear() override; // forgets every sprite, keeps the buffers
 
-        template<typename SpriteType> void insert(std::unique_ptr<SpriteType>& obj) { 
-            try {
-                // If no child nodes exist, add the object to this node
-                if (nodes.empty()) {
-                    objects.push_back(obj.get());
-                    log_info("Sprite inserted into quadtree node.");
-                } else {
-                    // Check which child node the object belongs to
-                    for (auto& node : nodes) {
-                        if (node->bounds.contains(obj->returnSpritesShape().getPosition())) {
-                            node->insert(obj);
-                            log_info("Sprite inserted into child node.");
-                            return;
-                        }
-                    }
-                }
-            } catch (const std::exception& e) {
-                log_error("Error during insert: " + std::string(e.what()));
-            }
-        }
+        using Broadphase::insert;
+        void insert(Sprite* sprite) override;
+        void remove(Sprite* sprite) override; // O(n), for sprites that are destroyed
+        void update() override; // re-sorts every sprite by its current bounds
+
+        void query(const sf::FloatRect& area, std::vector<Sprite*>& result) const override;
+        void queryFrustum(const ViewFrustum& frustum, std::vector<Sprite*>& result) const override; // nodes outside the triangle are skipped
+        void findPairs(std::vector<std::pair<Sprite*, Sprite*>>& pairs) const override;
 
-        std::vector<Sprite*> query(const sf::FloatRect& area) const;
-        void subdivide();
-        bool contains(const sf::FloatRect& bounds) const;
-        void update(); 
+        size_t getSpriteCount() const override { return sprites.size(); }
+        size_t getNodeCount() const { return nodeCount; }
+        const sf::FloatRect& getBounds() const { return bounds; }
 
     private:
-        size_t maxObjects;
-        size_t maxLevels;
-        size_t level;
-        sf::FloatRect bounds;
+        struct Item {
+            Sprite* sprite;
+            sf::FloatRect bounds; // as of the last update
+        };
+
+        size_t nodeIndex(const sf::FloatRect& itemBounds) const; // preorder index of the deepest node holding the bounds
+        sf::FloatRect nodeBounds(size_t level, size_t x, size_t y) const;
+        template<typename Test> void queryNode(size_t node, size_t level, size_t x, size_t y, const Test& test, std::vector<Sprite*>& result) const;
+        void findPairs(size_t node, size_t level, std::vector<std::pair<Sprite*, Sprite*>>& pairs) const;
 
-        std::vector<Sprite*> objects;
-        std::vector<std::unique_ptr<Quadtree>> nodes;
+        sf::FloatRect bounds;
+        size_t maxLevels;
+        size_t nodeCount;
+        std::vector<size_t> subtreeSizes; // nodes in a subtree rooted at each level
+
+        std::vector<Sprite*> sprites; // everything inserted, in insertion order
+        std::vector<uint32_t> itemNodes; // node of sprites[i], filled by update
+        std::vector<sf::FloatRect> itemBounds;
+        std::vector<uint32_t> nodeStarts; // nodeCount + 1 offsets into items, node n owns [nodeStarts[n], nodeStarts[n + 1])
+        std::vector<Item> items; // sorted by node
     };
 
     struct RaycastResult {
@@ -109,7 +119,6 @@ namespace physics{
         }
         sprite->updatePos();  // Update sprite's position after applying the move function
     }
-    void calculateRayCast3d(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& tileMap, sf::VertexArray& rays, sf::VertexArray& wallLine);
 
     //circle-shaped sprite collision
     bool circleCollision(const sf::Vector2f pos1, float radius1, const sf::Vector2f pos2, float radius2);
@@ -121,6 +130,9 @@ namespace physics{
     //pixel perfect collision
     bool pixelPerfectCollision( const std::shared_ptr<sf::Uint8[]> &bitmask1, const sf::Vector2f &position1, const sf::Vector2f &size1,
                                 const std::shared_ptr<sf::Uint8[]> &bitmask2, const sf::Vector2f &position2, const sf::Vector2f &size2);  
+    // the same with the row kernel picked by the caller: AVX2 (only where detectRayKernel reports it) or the 64-bit word loop of the others
+    bool pixelPerfectCollision(const std::shared_ptr<sf::Uint8[]>& bitmask1, const sf::Vector2f& position1, const sf::Vector2f& size1,
+                               const std::shared_ptr<sf::Uint8[]>& bitmask2, const sf::Vector2f& position2, const sf::Vector2f& size2, RayKernel kernel);
     bool pixelPerfectCollision(const std::shared_ptr<sf::Uint8[]>& bitmask1, const sf::Vector2f& position1, const sf::Vector2f& size1,
         const std::shared_ptr<sf::Uint8[]>& bitmask2, const sf::Vector2f& position2, const sf::Vector2f& size2,
         float angle1, float angle2);
@@ -199,7 +211,7 @@ namespace physics{
                 int tileX = static_cast<int>((data1.position.x - Constants::TILEMAP_POSITION.x) / Constants::TILE_WIDTH);
                 int tileY = static_cast<int>((data1.position.y - Constants::TILEMAP_POSITION.y) / Constants::TILE_HEIGHT);
 
-                std::unique_ptr<Tile>& tile = tileMap.getTile(tileY * tileMap.getTileMapWidth() + tileX);
+                const std::shared_ptr<Tile>& tile = tileMap.getTile(tileY * tileMap.getTileMapWidth() + tileX);
                 auto bitmask2 = tile->getBitMask().lock();
                 if (!bitmask2) {
                     // Handle the case where the bitmask is no longer available (locked from weak_ptr)
@@ -230,7 +242,7 @@ namespace physics{
     }
 
     template<typename ObjType1, typename ObjType2, typename CollisionType> // for sprite vs. sprite
-    bool collisionHelper(ObjType1&& obj1, ObjType2&& obj2, const CollisionType& collisionFunc, Quadtree* quadtree = nullptr, float timeElapsed = 0.0f, size_t counterIndex = 0) { // for sprive vs. sprite
+    bool collisionHelper(ObjType1&& obj1, ObjType2&& obj2, const CollisionType& collisionFunc, Broadphase* broadphase = nullptr, float timeElapsed = 0.0f, size_t counterIndex = 0) { // for sprive vs. sprite
         // Check if obj1 and obj2 are valid pointers
         if (!obj1) {
             log_warning("First object is missing in collision detection");
@@ -271,22 +283,14 @@ namespace physics{
             return false; // No collision detected
         };
 
-        if(quadtree){
-            auto potentialColliders1 = quadtree->query(sprite1->returnSpritesShape().getGlobalBounds());
-            auto potentialColliders2 = quadtree->query(sprite2->returnSpritesShape().getGlobalBounds());
-
-            if (potentialColliders1.empty() || potentialColliders2.empty()) return false;
-
-            for (const auto& collider1 : potentialColliders1) {
-                for (const auto& collider2 : potentialColliders2) {
-                    if (collider1 == collider2) continue;  // Skip self-collision checks
-                    
-                    return collisionLambda(data1, data2, collisionFunc);
-                }
-            }
-        } else {
-            return collisionLambda(data1, data2, collisionFunc);
+        // the narrow test only runs when the broadphase has the two near each other (bounds of its last update); a prediction looks ahead, so it always runs
+        if constexpr (!std::is_invocable_v<CollisionType, sf::Vector2f, sf::Vector2f, float, sf::FloatRect, sf::Vector2f>) {
+            auto asSprite = [](const auto& obj) -> const Sprite& {
+                if constexpr (std::is_base_of_v<Sprite, std::decay_t<decltype(obj)>>) return obj;
+                else return *obj; // unique_ptr<DerivedSprite>
+            };
+            if (broadphase && !broadphase->mayOverlap(asSprite(sprite1), asSprite(sprite2))) return false;
         }
-        return false; // default 
+        return collisionLambda(data1, data2, collisionFunc);
     }
 }    
\ No newline at end of file
@@ -0,0 +1,479 @@
+//
+//  raycast.cpp
+//
+//
+
+#include "raycast.hpp"
+#include "raypacket.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace physics {
+    RayCastFrame cachedRayCastFrame {};
+
+    RayHit castRay(const TileMap& tileMap, sf::Vector2f origin, sf::Vector2f direction, sf::Vector2f viewDirection, float maxDistance) {
+        RayHit result;
+        result.hitPoint = origin;
+
+        float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+        if (length == 0.0f) return result;
+        direction /= length;
+
+        float tileWidth = tileMap.getTileWidth();
+        float tileHeight = tileMap.getTileHeight();
+        long mapWidth = static_cast<long>(tileMap.getTileMapWidth());
+        long mapHeight = static_cast<long>(tileMap.getTileMapHeight());
+
+        // ray origin relative to the top left corner of the map
+        sf::Vector2f local = origin - tileMap.getTileMapPosition();
+        long cellX = static_cast<long>(std::floor(local.x / tileWidth));
+        long cellY = static_cast<long>(std::floor(local.y / tileHeight));
+
+        const float infinity = std::numeric_limits<float>::infinity();
+        long stepX = direction.x < 0.0f ? -1 : 1;
+        long stepY = direction.y < 0.0f ? -1 : 1;
+
+        // distance along the ray needed to cross one whole tile on each axis
+        float deltaX = direction.x != 0.0f ? tileWidth / std::abs(direction.x) : infinity;
+        float deltaY = direction.y != 0.0f ? tileHeight / std::abs(direction.y) : infinity;
+
+        // distance along the ray to the first vertical / horizontal tile boundary
+        float nextX = direction.x < 0.0f ? local.x - cellX * tileWidth : (cellX + 1) * tileWidth - local.x;
+        float nextY = direction.y < 0.0f ? local.y - cellY * tileHeight : (cellY + 1) * tileHeight - local.y;
+        float sideX = direction.x != 0.0f ? nextX / std::abs(direction.x) : infinity;
+        float sideY = direction.y != 0.0f ? nextY / std::abs(direction.y) : infinity;
+
+        float distance = 0.0f;
+        HitSide side = HitSide::NONE;
+
+        while (true) {
+            if (sideX < sideY) {
+                distance = sideX;
+                sideX += deltaX;
+                cellX += stepX;
+                side = stepX > 0 ? HitSide::WEST : HitSide::EAST;
+            } else {
+                distance = sideY;
+                sideY += deltaY;
+                cellY += stepY;
+                side = stepY > 0 ? HitSide::NORTH : HitSide::SOUTH;
+            }
+
+            if (distance > maxDistance) { distance = maxDistance; break; }
+            if (cellX < 0 || cellY < 0 || cellX >= mapWidth || cellY >= mapHeight) break; // ray left the map
+
+            if (!tileMap.isWalkable(static_cast<size_t>(cellX), static_cast<size_t>(cellY))) {
+                result.hit = true;
+                result.tileX = static_cast<size_t>(cellX);
+                result.tileY = static_cast<size_t>(cellY);
+                result.tileIndex = result.tileY * tileMap.getTileMapWidth() + result.tileX;
+                result.side = side;
+                break;
+            }
+        }
+
+        result.distance = distance;
+        result.hitPoint = origin + direction * distance;
+        result.perpDistance = distance * (direction.x * viewDirection.x + direction.y * viewDirection.y);
+        if (result.hit) result.wallOffset = wallHitOffset(tileMap, result);
+        return result;
+    }
+
+    RayTraversal parseRayTraversal(const std::string& name) {
+        if (name == "dda") return RayTraversal::DDA;
+        if (name == "mipgrid") return RayTraversal::MIPGRID;
+        if (name == "distance") return RayTraversal::DISTANCE;
+        log_warning("Unknown ray traversal \"" + name + "\", using dda");
+        return RayTraversal::DDA;
+    }
+
+    std::string rayTraversalName(RayTraversal traversal) {
+        switch (traversal) {
+            case RayTraversal::MIPGRID: return "mipgrid";
+            case RayTraversal::DISTANCE: return "distance";
+            default: return "dda";
+        }
+    }
+
+    namespace {
+        struct OpenBlock {
+            long minX, minY, maxX, maxY; // inclusive cell range
+        };
+    }
+
+    /* castRay's walk, except that when findOpenBlock(cellX, cellY, block) reports a rect of cells around the ray's cell
+    that are all walkable, the ray jumps straight to where it leaves that rect */
+    template <typename FindOpenBlock>
+    RayHit castRayThroughOpenBlocks(const TileMap& tileMap, sf::Vector2f origin, sf::Vector2f direction, sf::Vector2f viewDirection, float maxDistance, FindOpenBlock findOpenBlock) {
+        RayHit result;
+        result.hitPoint = origin;
+
+        float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+        if (length == 0.0f) return result;
+        direction /= length;
+
+        float tileWidth = tileMap.getTileWidth();
+        float tileHeight = tileMap.getTileHeight();
+        long mapWidth = static_cast<long>(tileMap.getTileMapWidth());
+        long mapHeight = static_cast<long>(tileMap.getTileMapHeight());
+
+        sf::Vector2f local = origin - tileMap.getTileMapPosition();
+        long cellX = static_cast<long>(std::floor(local.x / tileWidth));
+        long cellY = static_cast<long>(std::floor(local.y / tileHeight));
+
+        const float infinity = std::numeric_limits<float>::infinity();
+        long stepX = direction.x < 0.0f ? -1 : 1;
+        long stepY = direction.y < 0.0f ? -1 : 1;
+        float inverseX = direction.x != 0.0f ? 1.0f / std::abs(direction.x) : infinity;
+        float inverseY = direction.y != 0.0f ? 1.0f / std::abs(direction.y) : infinity;
+
+        // distance along the ray to the far boundary of column / row cell, measured from the origin so big jumps don't accumulate error
+        auto boundaryX = [&](long cell) { return direction.x != 0.0f ? (stepX > 0 ? (cell + 1) * tileWidth - local.x : local.x - cell * tileWidth) * inverseX : infinity; };
+        auto boundaryY = [&](long cell) { return direction.y != 0.0f ? (stepY > 0 ? (cell + 1) * tileHeight - local.y : local.y - cell * tileHeight) * inverseY : infinity; };
+
+        float distance = 0.0f;
+        HitSide side = HitSide::NONE;
+
+        while (true) {
+            bool inside = cellX >= 0 && cellY >= 0 && cellX < mapWidth && cellY < mapHeight;
+            OpenBlock block { cellX, cellY, cellX, cellY };
+            bool jump = inside && findOpenBlock(cellX, cellY, block);
+
+            // last cell of the current block (or the cell itself) the ray passes on each axis
+            long lastX = stepX > 0 ? block.maxX : block.minX;
+            long lastY = stepY > 0 ? block.maxY : block.minY;
+            float exitX = boundaryX(lastX), exitY = boundaryY(lastY);
+
+            /* after a block jump the cell on the other axis is the one the ray is in at the exit distance. it's guessed from
+            the exit point (never behind the cell it came from) and then corrected with the same boundary distances, keeping castRay's rule that a tie crosses
+            the horizontal boundary first, so rays through block corners visit the same cells as castRay */
+            if (exitX < exitY) {
+                distance = exitX;
+                cellX = lastX + stepX;
+                if (jump && direction.y != 0.0f) {
+                    long y = std::clamp(static_cast<long>(std::floor((local.y + direction.y * distance) / tileHeight)), std::min(cellY, lastY), std::max(cellY, lastY));
+                    while (y != lastY && boundaryY(y) <= distance) y += stepY;
+                    while (y != cellY && boundaryY(y - stepY) > distance) y -= stepY;
+                    cellY = y;
+                }
+                side = stepX > 0 ? HitSide::WEST : HitSide::EAST;
+            } else {
+                distance = exitY;
+                cellY = lastY + stepY;
+                if (jump && direction.x != 0.0f) {
+                    long x = std::clamp(static_cast<long>(std::floor((local.x + direction.x * distance) / tileWidth)), std::min(cellX, lastX), std::max(cellX, lastX));
+                    while (x != lastX && boundaryX(x) < distance) x += stepX;
+                    while (x != cellX && boundaryX(x - stepX) >= distance) x -= stepX;
+                    cellX = x;
+                }
+                side = stepY > 0 ? HitSide::NORTH : HitSide::SOUTH;
+            }
+
+            if (distance > maxDistance) { distance = maxDistance; break; }
+            if (cellX < 0 || cellY < 0 || cellX >= mapWidth || cellY >= mapHeight) break; // ray left the map
+
+            if (!tileMap.isWalkable(static_cast<size_t>(cellX), static_cast<size_t>(cellY))) {
+                result.hit = true;
+                result.tileX = static_cast<size_t>(cellX);
+                result.tileY = static_cast<size_t>(cellY);
+                result.tileIndex = result.tileY * tileMap.getTileMapWidth() + result.tileX;
+                result.side = side;
+                break;
+            }
+        }
+
+        result.distance = distance;
+        result.hitPoint = origin + direction * distance;
+        result.perpDistance = distance * (direction.x * viewDirection.x + direction.y * viewDirection.y);
+        if (result.hit) result.wallOffset = wallHitOffset(tileMap, result);
+        return result;
+    }
+
+    RayHit castRayMipGrid(const TileMap& tileMap, sf::Vector2f origin, sf::Vector2f direction, sf::Vector2f viewDirection, float maxDistance) {
+        return castRayThroughOpenBlocks(tileMap, origin, direction, viewDirection, maxDistance, [&](long cellX, long cellY, OpenBlock& block) {
+            unsigned int shift = tileMap.getOpenBlockShift(static_cast<size_t>(cellX), static_cast<size_t>(cellY));
+            if (shift == 0) return false;
+            long blockMask = (1L << shift) - 1;
+            block = { cellX & ~blockMask, cellY & ~blockMask, cellX | blockMask, cellY | blockMask };
+            return true;
+        });
+    }
+
+    RayHit castRayDistanceField(const TileMap& tileMap, const DistanceField& field, sf::Vector2f origin, sf::Vector2f direction, sf::Vector2f viewDirection, float maxDistance) {
+        return castRayThroughOpenBlocks(tileMap, origin, direction, viewDirection, maxDistance, [&](long cellX, long cellY, OpenBlock& block) {
+            long radius = static_cast<long>(field.getDistance(static_cast<size_t>(cellX), static_cast<size_t>(cellY))) - 1;
+            if (radius <= 0) return false;
+            block = { cellX - radius, cellY - radius, cellX + radius, cellY + radius };
+            return true;
+        });
+    }
+
+    float wallHitOffset(const TileMap& tileMap, const RayHit& hit) {
+        sf::Vector2f local = hit.hitPoint - tileMap.getTileMapPosition();
+
+        // fraction of the tile along the face; west/east faces run along y, north/south faces along x
+        bool alongY = hit.side == HitSide::WEST || hit.side == HitSide::EAST;
+        float position = alongY ? local.y / tileMap.getTileHeight() - hit.tileY : local.x / tileMap.getTileWidth() - hit.tileX;
+        float offset = std::clamp(position, 0.0f, 1.0f);
+
+        // the screen's x axis runs along the camera plane (view direction turned clockwise), flip faces seen from +y / -x
+        if (hit.side == HitSide::EAST || hit.side == HitSide::NORTH) offset = 1.0f - offset;
+        return offset;
+    }
+
+    void shadeWallColumn(WallColumn& column) {
+        float correctedDistance = std::max(1.0f, column.ray.perpDistance); // Prevent division by zero or extreme values
+        column.wallHeight = wallHeightScale / correctedDistance; // Compute projected wall height
+
+        // Adjust brightness based on distance
+        float brightnessFactor = std::max(0.2f, 1.0f - (correctedDistance / wallShadeDistance));
+        column.shade = static_cast<sf::Uint8>(50 + 150 * brightnessFactor);
+    }
+
+    namespace {
+        // > 0 when p is left of the line a -> b (y axis pointing down)
+        float edgeSide(sf::Vector2f a, sf::Vector2f b, sf::Vector2f p) {
+            return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+        }
+    }
+
+    ViewFrustum makeViewFrustum(const RayCastFrame& frame, float farDistance) {
+        sf::Vector2f cameraPlane = frame.rayTable.getCameraPlane(frame.viewDirection);
+        ViewFrustum frustum;
+        frustum.origin = frame.origin;
+        frustum.farLeft = frame.origin + (frame.viewDirection - cameraPlane) * farDistance;
+        frustum.farRight = frame.origin + (frame.viewDirection + cameraPlane) * farDistance;
+        return frustum;
+    }
+
+    sf::FloatRect ViewFrustum::getBounds() const {
+        float left = std::min({ origin.x, farLeft.x, farRight.x });
+        float top = std::min({ origin.y, farLeft.y, farRight.y });
+        float right = std::max({ origin.x, farLeft.x, farRight.x });
+        float bottom = std::max({ origin.y, farLeft.y, farRight.y });
+        return { left, top, right - left, bottom - top };
+    }
+
+    bool ViewFrustum::intersects(const sf::FloatRect& rect) const {
+        sf::FloatRect bounds = getBounds();
+        if (rect.left > bounds.left + bounds.width || rect.left + rect.width < bounds.left || rect.top > bounds.top + bounds.height || rect.top + rect.height < bounds.top) return false;
+
+        // rect is outside if all of its corners are on the outer side of one edge
+        const sf::Vector2f corners[4] = { { rect.left, rect.top }, { rect.left + rect.width, rect.top },
+                                          { rect.left, rect.top + rect.height }, { rect.left + rect.width, rect.top + rect.height } };
+        const sf::Vector2f triangle[3] = { origin, farLeft, farRight };
+        float winding = edgeSide(origin, farLeft, farRight) < 0.0f ? -1.0f : 1.0f;
+
+        for (int edge = 0; edge < 3; ++edge) {
+            sf::Vector2f a = triangle[edge];
+            sf::Vector2f b = triangle[(edge + 1) % 3];
+            bool allOutside = true;
+            for (const sf::Vector2f& corner : corners) {
+                if (edgeSide(a, b, corner) * winding >= 0.0f) { allOutside = false; break; }
+            }
+            if (allOutside) return false;
+        }
+        return true;
+    }
+
+    bool ViewFrustum::contains(sf::Vector2f point, float radius) const {
+        const sf::Vector2f triangle[3] = { origin, farLeft, farRight };
+        float winding = edgeSide(origin, farLeft, farRight) < 0.0f ? -1.0f : 1.0f;
+
+        for (int edge = 0; edge < 3; ++edge) {
+            sf::Vector2f a = triangle[edge];
+            sf::Vector2f b = triangle[(edge + 1) % 3];
+            float length = std::sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+            if (length == 0.0f) continue;
+            if (edgeSide(a, b, point) * winding / length < -radius) return false;
+        }
+        return true;
+    }
+
+    namespace {
+        // segment a -> b touches the rect (slab test), used to find the cached rays an edit could have changed
+        bool segmentTouchesRect(sf::Vector2f a, sf::Vector2f b, const sf::FloatRect& rect) {
+            float enter = 0.0f, leave = 1.0f;
+            const float start[2] = { a.x, a.y }, delta[2] = { b.x - a.x, b.y - a.y };
+            const float low[2] = { rect.left, rect.top }, high[2] = { rect.left + rect.width, rect.top + rect.height };
+            for (int axis = 0; axis < 2; ++axis) {
+                if (delta[axis] == 0.0f) {
+                    if (start[axis] < low[axis] || start[axis] > high[axis]) return false;
+                    continue;
+                }
+                float t0 = (low[axis] - start[axis]) / delta[axis], t1 = (high[axis] - start[axis]) / delta[axis];
+                if (t0 > t1) std::swap(t0, t1);
+                enter = std::max(enter, t0);
+                leave = std::min(leave, t1);
+                if (enter > leave) return false;
+            }
+            return true;
+        }
+
+        // whether the view turned by a whole number of angle steps since the cached frame, and by how many
+        bool turnedByAngleSteps(float heading, float cachedHeading, float angleStep, long& steps) {
+            float turn = std::remainder(heading - cachedHeading, 360.0f);
+            if (turn == 0.0f) {
+                steps = 0;
+                return true;
+            }
+            if (angleStep <= 0.0f) return false;
+            float wholeSteps = std::round(turn / angleStep);
+            steps = static_cast<long>(wholeSteps);
+            return std::abs(turn - wholeSteps * angleStep) <= angleStep * 1e-3f;
+        }
+    }
+
+    void calculateRayCast3d(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& tileMap, sf::VertexArray& lines, RayTraversal traversal, JobSystem* jobSystem, size_t columnCount) {
+        if(!player || !tileMap){
+            log_error("tile or player is not initialized");
+            return;
+        }
+
+        sf::Vector2f origin = player->getSpritePos();
+        sf::Vector2f viewDirection = player->getDirectionVector(); // updated by setHeadingAngle, no trig needed here
+        float heading = player->getHeadingAngle();
+
+        size_t itCount = columnCount ? columnCount : Constants::RAYS_NUM / 2;
+        sf::Vector2f viewSize = MetaComponents::bigView.getSize();
+
+        RayCastFrame& frame = cachedRayCastFrame;
+        const RayTable& table = frame.rayTable;
+        bool tableChanged = frame.rayTable.update(Constants::FOV, itCount, viewSize);
+        sf::Vector2f cameraPlane = table.getCameraPlane(viewDirection);
+
+        // fixed size buffers (no reallocation once the ray count is stable): column i owns lines[2i..2i+1]
+        lines.setPrimitiveType(sf::Lines);
+        lines.resize(2 * itCount); // Ensure enough space for ray visualization
+
+        frame.directionX.resize(itCount);
+        frame.directionY.resize(itCount);
+        frame.columns.resize(itCount);
+        frame.depth.resize(itCount);
+        frame.castMask.assign(itCount, 0);
+
+        const TileMap& map = *tileMap;
+        RayKernel kernel = detectRayKernel();
+        if (traversal == RayTraversal::DISTANCE) cachedDistanceField.sync(map, jobSystem); // before the cast, it may use the workers itself
+
+        // what can be kept from the last frame: nothing, everything, or the columns a turn by whole angle steps didn't expose
+        frame.mapChanges.clear();
+        bool reuse = Constants::RAY_CACHE && frame.cacheValid && !tableChanged && traversal == frame.traversal && origin == frame.origin &&
+                     map.getMapId() == frame.mapId && map.getWalkableChangesSince(frame.walkableVersion, frame.mapChanges);
+        long shift = 0;
+        reuse = reuse && turnedByAngleSteps(heading, frame.heading, table.getAngleStep(), shift);
+
+        size_t castCount = 0;
+        if (!reuse || std::abs(shift) >= static_cast<long>(itCount)) {
+            std::fill(frame.castMask.begin(), frame.castMask.end(), 1);
+            castCount = itCount;
+        } else {
+            if (shift != 0) {
+                // column i now looks where column i + shift did; its hit stays, only the projection on the new view changes
+                if (shift > 0) std::move(frame.columns.begin() + shift, frame.columns.end(), frame.columns.begin());
+                else std::move_backward(frame.columns.begin(), frame.columns.end() + shift, frame.columns.end());
+                size_t exposedBegin = shift > 0 ? itCount - static_cast<size_t>(shift) : 0;
+                size_t exposedEnd = shift > 0 ? itCount : static_cast<size_t>(-shift);
+                for (size_t i = 0; i < itCount; ++i) {
+                    if (i >= exposedBegin && i < exposedEnd) {
+                        frame.castMask[i] = 1;
+                        continue;
+                    }
+                    WallColumn& column = frame.columns[i];
+                    column.ray.perpDistance = column.ray.distance * table.getFisheyeFactor(i);
+                    shadeWallColumn(column);
+                }
+            }
+
+            // rays that crossed (or stopped at) a tile whose walkability changed
+            for (const sf::IntRect& changed : frame.mapChanges) {
+                sf::FloatRect area(map.getTileMapPosition().x + changed.left * map.getTileWidth() - 0.01f, map.getTileMapPosition().y + changed.top * map.getTileHeight() - 0.01f,
+                                   changed.width * map.getTileWidth() + 0.02f, changed.height * map.getTileHeight() + 0.02f);
+                for (size_t i = 0; i < itCount; ++i) {
+                    if (!frame.castMask[i] && segmentTouchesRect(origin, frame.columns[i].ray.hitPoint, area)) frame.castMask[i] = 1;
+                }
+            }
+            castCount = static_cast<size_t>(std::count(frame.castMask.begin(), frame.castMask.end(), 1));
+        }
+
+        auto castColumns = [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                sf::Vector2f direction = table.getRayDirection(i, viewDirection, cameraPlane);
+                frame.directionX[i] = direction.x;
+                frame.directionY[i] = direction.y;
+            }
+
+            if (traversal == RayTraversal::MIPGRID || traversal == RayTraversal::DISTANCE) {
+                for (size_t i = begin; i < end; ++i) {
+                    WallColumn& column = frame.columns[i];
+                    sf::Vector2f direction(frame.directionX[i], frame.directionY[i]);
+                    column.ray = traversal == RayTraversal::MIPGRID ? castRayMipGrid(map, origin, direction, viewDirection, maxRayDistance)
+                                                                    : castRayDistanceField(map, cachedDistanceField, origin, direction, viewDirection, maxRayDistance);
+                    shadeWallColumn(column);
+                }
+            } else {
+                castRayPacket(map, origin, &frame.directionX[begin], &frame.directionY[begin], end - begin, viewDirection, maxRayDistance, &frame.columns[begin], kernel);
+            }
+        };
+
+        if (castCount == itCount && jobSystem) {
+            // a few chunks per thread so faster threads can steal the columns left over by long rays; whole packets of 8 rays per chunk
+            size_t chunkSize = std::max<size_t>(8, itCount / (jobSystem->getThreadCount() * 4));
+            chunkSize = (chunkSize + 7) / 8 * 8;
+            jobSystem->parallelFor(itCount, chunkSize, castColumns);
+        } else if (castCount > 0) {
+            // runs of columns to recast, usually a few at the edge of a turn or around an edit
+            for (size_t begin = 0; begin < itCount;) {
+                if (!frame.castMask[begin]) { ++begin; continue; }
+                size_t end = begin;
+                while (end < itCount && frame.castMask[end]) ++end;
+                castColumns(begin, end, 0);
+                begin = end;
+            }
+        }
+        if (shift != 0 && castCount < itCount) {
+            for (size_t i = 0; i < itCount; ++i) {
+                sf::Vector2f direction = table.getRayDirection(i, viewDirection, cameraPlane);
+                frame.directionX[i] = direction.x;
+                frame.directionY[i] = direction.y;
+            }
+        }
+
+        bool columnsChanged = castCount > 0 || shift != 0;
+        if (columnsChanged) {
+            for (size_t i = 0; i < itCount; ++i) {
+                const WallColumn& column = frame.columns[i];
+                frame.depth[i] = column.ray.hit ? column.ray.perpDistance : maxRayDistance;
+
+                // Store raycasting lines for debugging (2D representation)
+                lines[2 * i].position = origin;
+                lines[2 * i + 1].position = column.ray.hitPoint;
+                lines[2 * i].color = sf::Color::Red;
+                lines[2 * i + 1].color = sf::Color::Red;
+            }
+        }
+
+        // walked again for the cells rather than recorded by the kernels, which skip open blocks and step 8 rays at a time
+        if (Constants::VISIBLE_CELLS && (columnsChanged || !frame.visibleCells.isBuiltFor(map))) {
+            VisibleCells& visible = frame.visibleCells;
+            visible.begin(map, origin, maxRayDistance);
+            for (size_t i = 0; i < itCount; ++i) {
+                const RayHit& ray = frame.columns[i].ray;
+                visible.markRay(map, origin, sf::Vector2f(frame.directionX[i], frame.directionY[i]), ray.distance);
+                if (ray.hit) visible.markCell(ray.tileX, ray.tileY);
+            }
+        }
+
+        frame.changed = columnsChanged || map.getContentVersion() != frame.contentVersion || !frame.cacheValid;
+        frame.castCount = castCount;
+        frame.origin = origin;
+        frame.viewDirection = viewDirection;
+        frame.heading = heading;
+        frame.cacheValid = true;
+        frame.traversal = traversal;
+        frame.mapId = map.getMapId();
+        frame.walkableVersion = map.getWalkableVersion();
+        frame.contentVersion = map.getContentVersion();
+    }
+}
@@ -0,0 +1,112 @@
+//
+//  raycast.hpp
+//
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "../../test-assets/sprites/sprites.hpp"
+#include "../../test-assets/tiles/tiles.hpp"
+#include "../core/jobs.hpp"
+#include "raytable.hpp"
+#include "distancefield.hpp"
+#include "visiblecells.hpp"
+
+namespace physics {
+    // how rays walk the grid, picked with world: ray_traversal in config.yaml
+    enum class RayTraversal { DDA, MIPGRID, DISTANCE };
+    RayTraversal parseRayTraversal(const std::string& name); // unknown names fall back to DDA with a warning
+    std::string rayTraversalName(RayTraversal traversal);
+
+    // face of the tile that a ray ran into
+    enum class HitSide { NONE, NORTH, SOUTH, EAST, WEST };
+
+    // result of walking a single ray through the tile grid
+    struct RayHit {
+        bool hit = false; // false when the ray left the map or ran out of distance
+        size_t tileX {};
+        size_t tileY {};
+        size_t tileIndex {}; // tileY * tileMapWidth + tileX
+        HitSide side = HitSide::NONE;
+        sf::Vector2f hitPoint {}; // where the ray stopped (wall, map edge or max distance)
+        float distance {}; // euclidean distance from origin to hitPoint
+        float perpDistance {}; // distance projected on the view direction (no fisheye)
+        float wallOffset {}; // where the ray hit the face, 0 at its left edge to 1 at its right edge as seen from the origin
+    };
+
+    // a ray's hit plus what the wall pass needs to draw its column
+    struct WallColumn {
+        RayHit ray;
+        float wallHeight {}; // projected height in screen pixels
+        sf::Uint8 shade {}; // grey level, darker with distance
+    };
+
+    /* buffers reused by calculateRayCast3d every frame; holds the last frame's column results, which double as a ray cache:
+    an unchanged pose keeps them, a turn by a whole number of angle steps shifts them and casts only the new columns,
+    and walkability edits (the tile map's change log) recast just the columns whose ray crossed an edited rect */
+    struct RayCastFrame {
+        RayTable rayTable; // rebuilt when FOV, ray count or view size changes
+        sf::Vector2f origin {}; // camera pose the columns were cast from
+        sf::Vector2f viewDirection {};
+        float heading {}; // degrees, the player's heading angle
+        std::vector<float> directionX;
+        std::vector<float> directionY;
+        std::vector<WallColumn> columns;
+        std::vector<float> depth; // per column perpendicular distance to the wall, maxRayDistance where nothing was hit
+        VisibleCells visibleCells; // tiles the columns' rays crossed, rebuilt with Constants::VISIBLE_CELLS whenever the columns change
+
+        bool changed = true; // false when the columns and the map's cells are the same as last frame, so its output can be drawn again
+        size_t castCount {}; // rays actually cast in the last frame
+
+        // what the cached columns are valid for
+        bool cacheValid = false;
+        RayTraversal traversal = RayTraversal::DDA;
+        uint64_t mapId {};
+        uint64_t walkableVersion {};
+        uint64_t contentVersion {};
+        std::vector<sf::IntRect> mapChanges;
+        std::vector<uint8_t> castMask; // columns to cast this frame
+    };
+    extern RayCastFrame cachedRayCastFrame;
+
+    // triangle from the camera out to farDistance between the outermost rays of a frame; picks billboard candidates
+    struct ViewFrustum {
+        sf::Vector2f origin {};
+        sf::Vector2f farLeft {};
+        sf::Vector2f farRight {};
+
+        bool intersects(const sf::FloatRect& rect) const; // conservative, may accept some rects just outside a corner
+        bool contains(sf::Vector2f point, float radius) const; // circle overlaps the triangle (same caveat)
+        sf::FloatRect getBounds() const; // axis aligned box around the triangle, for indexes that can only look up rects
+    };
+    ViewFrustum makeViewFrustum(const RayCastFrame& frame, float farDistance);
+
+    constexpr float wallHeightScale = 2500.0f; // Scale factor for wall height
+    constexpr float wallShadeDistance = 100.0f; // distance where walls reach their darkest shade
+    constexpr float maxRayDistance = 1000.0f; // Maximum allowed ray distance
+
+    // exact grid traversal (Amanatides & Woo); visits every tile boundary the ray crosses exactly once
+    RayHit castRay(const TileMap& tileMap, sf::Vector2f origin, sf::Vector2f direction, sf::Vector2f viewDirection, float maxDistance);
+
+    /* same walk as castRay, but a cell inside an all-walkable block of the tile map's occupancy pyramid (4x4, 16x16 or a
+    whole chunk) jumps straight to where the ray leaves that block; fine DDA steps are only taken next to walls */
+    RayHit castRayMipGrid(const TileMap& tileMap, sf::Vector2f origin, sf::Vector2f direction, sf::Vector2f viewDirection, float maxDistance);
+
+    // same again with the square around the ray's cell that the distance field says is open; the field has to be synced to the map
+    RayHit castRayDistanceField(const TileMap& tileMap, const DistanceField& field, sf::Vector2f origin, sf::Vector2f direction, sf::Vector2f viewDirection, float maxDistance);
+
+    // wallOffset for a ray that hit a wall, from its hitPoint and side
+    float wallHitOffset(const TileMap& tileMap, const RayHit& hit);
+
+    // fills in wallHeight and shade from column.ray.perpDistance
+    void shadeWallColumn(WallColumn& column);
+
+    // casts columnCount columns (RAYS_NUM / 2 when 0) with directions from the frame's RayTable into cachedRayCastFrame.columns (walls are built from them by WallMesh);
+    // every column owns 2 vertices of rays so chunks of columns can be cast on different threads. traversal is parsed from Constants::RAY_TRAVERSAL
+    // once by the caller, Constants::RAY_CACHE turns reusing the last frame's columns on and off, Constants::VISIBLE_CELLS building frame.visibleCells
+    void calculateRayCast3d(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& tileMap, sf::VertexArray& rays, RayTraversal traversal, JobSystem* jobSystem = nullptr, size_t columnCount = 0);
+}
@@ -0,0 +1,322 @@
+//
+//  raypacket.cpp
+//
+//
+
+#include "raypacket.hpp"
+
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    #define RAYPACKET_X86 1
+    #include <immintrin.h>
+#else
+    #define RAYPACKET_X86 0
+#endif
+
+#if RAYPACKET_X86 && (defined(__GNUC__) || defined(__clang__))
+    #define RAYPACKET_TARGET_AVX2 __attribute__((target("avx2")))
+    #define RAYPACKET_HAS_AVX2 1
+#else
+    #define RAYPACKET_HAS_AVX2 0
+#endif
+
+namespace physics {
+    namespace {
+        // everything that is the same for every ray of one castRayPacket call
+        struct PacketSetup {
+            const TileMap* tileMap;
+            sf::Vector2f origin;
+            sf::Vector2f viewDirection;
+            float maxDistance;
+            float tileWidth;
+            float tileHeight;
+            long mapWidth;
+            long mapHeight;
+            long cellX; // tile the origin is in
+            long cellY;
+            float nextXNegative; // distance to the first vertical boundary when walking left / right
+            float nextXPositive;
+            float nextYNegative;
+            float nextYPositive;
+        };
+
+        PacketSetup makeSetup(const TileMap& tileMap, sf::Vector2f origin, sf::Vector2f viewDirection, float maxDistance) {
+            PacketSetup setup;
+            setup.tileMap = &tileMap;
+            setup.origin = origin;
+            setup.viewDirection = viewDirection;
+            setup.maxDistance = maxDistance;
+            setup.tileWidth = tileMap.getTileWidth();
+            setup.tileHeight = tileMap.getTileHeight();
+            setup.mapWidth = static_cast<long>(tileMap.getTileMapWidth());
+            setup.mapHeight = static_cast<long>(tileMap.getTileMapHeight());
+
+            // same expressions as castRay so both kernels start from bit-identical values
+            sf::Vector2f local = origin - tileMap.getTileMapPosition();
+            setup.cellX = static_cast<long>(std::floor(local.x / setup.tileWidth));
+            setup.cellY = static_cast<long>(std::floor(local.y / setup.tileHeight));
+            setup.nextXNegative = local.x - setup.cellX * setup.tileWidth;
+            setup.nextXPositive = (setup.cellX + 1) * setup.tileWidth - local.x;
+            setup.nextYNegative = local.y - setup.cellY * setup.tileHeight;
+            setup.nextYPositive = (setup.cellY + 1) * setup.tileHeight - local.y;
+            return setup;
+        }
+
+        // scalar part of a lockstep step: decides whether a lane stops in the tile it just entered
+        inline bool finishLane(const PacketSetup& setup, float distance, long cellX, long cellY, bool steppedX, int stepX, int stepY, RayHit& hit) {
+            if (distance > setup.maxDistance) {
+                hit.distance = setup.maxDistance;
+                return true;
+            }
+            hit.distance = distance;
+            if (cellX < 0 || cellY < 0 || cellX >= setup.mapWidth || cellY >= setup.mapHeight) return true; // ray left the map
+
+            if (!setup.tileMap->isWalkable(static_cast<size_t>(cellX), static_cast<size_t>(cellY))) {
+                hit.hit = true;
+                hit.tileX = static_cast<size_t>(cellX);
+                hit.tileY = static_cast<size_t>(cellY);
+                hit.tileIndex = hit.tileY * setup.tileMap->getTileMapWidth() + hit.tileX;
+                if (steppedX) hit.side = stepX > 0 ? HitSide::WEST : HitSide::EAST;
+                else hit.side = stepY > 0 ? HitSide::NORTH : HitSide::SOUTH;
+                return true;
+            }
+            return false;
+        }
+
+        // writes a finished lane into its column; perpDistance, wallHeight and shade come from the vector pass
+        inline void storeLane(const PacketSetup& setup, const RayHit& hit, float normalX, float normalY, float perpDistance, float wallHeight, int shade, WallColumn& column) {
+            column.ray = hit;
+            column.ray.hitPoint = setup.origin + sf::Vector2f(normalX, normalY) * hit.distance;
+            column.ray.perpDistance = perpDistance;
+            if (hit.hit) column.ray.wallOffset = wallHitOffset(*setup.tileMap, column.ray);
+            column.wallHeight = wallHeight;
+            column.shade = static_cast<sf::Uint8>(shade);
+        }
+
+        void castScalar(const PacketSetup& setup, const float* directionX, const float* directionY, size_t count, WallColumn* columns) {
+            for (size_t i = 0; i < count; ++i) {
+                columns[i].ray = castRay(*setup.tileMap, setup.origin, sf::Vector2f(directionX[i], directionY[i]), setup.viewDirection, setup.maxDistance);
+                shadeWallColumn(columns[i]);
+            }
+        }
+
+        bool hasZeroDirection(const float* directionX, const float* directionY, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                if (directionX[i] == 0.0f && directionY[i] == 0.0f) return true;
+            }
+            return false;
+        }
+
+#if RAYPACKET_X86
+        inline __m128 select(__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+        // 4 rays; SSE2 is part of every x86-64 CPU so this needs no runtime check
+        void castPacketSSE(const PacketSetup& setup, const float* directionX, const float* directionY, WallColumn* columns) {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+            __m128 dirX = _mm_loadu_ps(directionX);
+            __m128 dirY = _mm_loadu_ps(directionY);
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dirX, dirX), _mm_mul_ps(dirY, dirY)));
+            dirX = _mm_div_ps(dirX, length);
+            dirY = _mm_div_ps(dirY, length);
+
+            __m128 absX = _mm_and_ps(dirX, absMask);
+            __m128 absY = _mm_and_ps(dirY, absMask);
+            __m128 negativeX = _mm_cmplt_ps(dirX, zero);
+            __m128 negativeY = _mm_cmplt_ps(dirY, zero);
+            __m128i stepX = _mm_or_si128(_mm_castps_si128(negativeX), _mm_andnot_si128(_mm_castps_si128(negativeX), _mm_set1_epi32(1)));
+            __m128i stepY = _mm_or_si128(_mm_castps_si128(negativeY), _mm_andnot_si128(_mm_castps_si128(negativeY), _mm_set1_epi32(1)));
+
+            // tileWidth / 0 is +inf, which is what castRay uses for axis aligned rays
+            __m128 deltaX = _mm_div_ps(_mm_set1_ps(setup.tileWidth), absX);
+            __m128 deltaY = _mm_div_ps(_mm_set1_ps(setup.tileHeight), absY);
+            __m128 nextX = select(negativeX, _mm_set1_ps(setup.nextXNegative), _mm_set1_ps(setup.nextXPositive));
+            __m128 nextY = select(negativeY, _mm_set1_ps(setup.nextYNegative), _mm_set1_ps(setup.nextYPositive));
+            __m128 sideX = select(_mm_cmpeq_ps(dirX, zero), infinity, _mm_div_ps(nextX, absX));
+            __m128 sideY = select(_mm_cmpeq_ps(dirY, zero), infinity, _mm_div_ps(nextY, absY));
+            __m128i cellX = _mm_set1_epi32(static_cast<int>(setup.cellX));
+            __m128i cellY = _mm_set1_epi32(static_cast<int>(setup.cellY));
+
+            alignas(16) float laneDistance[4];
+            alignas(16) int laneCellX[4], laneCellY[4], laneStepX[4], laneStepY[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(laneStepX), stepX);
+            _mm_store_si128(reinterpret_cast<__m128i*>(laneStepY), stepY);
+
+            RayHit hits[4];
+            int active = 0xF;
+            while (active) {
+                __m128 chooseX = _mm_cmplt_ps(sideX, sideY);
+                __m128i chooseXi = _mm_castps_si128(chooseX);
+                __m128 distance = select(chooseX, sideX, sideY);
+                sideX = _mm_add_ps(sideX, _mm_and_ps(chooseX, deltaX));
+                sideY = _mm_add_ps(sideY, _mm_andnot_ps(chooseX, deltaY));
+                cellX = _mm_add_epi32(cellX, _mm_and_si128(chooseXi, stepX));
+                cellY = _mm_add_epi32(cellY, _mm_andnot_si128(chooseXi, stepY));
+
+                _mm_store_ps(laneDistance, distance);
+                _mm_store_si128(reinterpret_cast<__m128i*>(laneCellX), cellX);
+                _mm_store_si128(reinterpret_cast<__m128i*>(laneCellY), cellY);
+                int steppedX = _mm_movemask_ps(chooseX);
+
+                for (int lane = 0; lane < 4; ++lane) {
+                    if (!(active & (1 << lane))) continue; // lane already terminated, keep its result
+                    if (finishLane(setup, laneDistance[lane], laneCellX[lane], laneCellY[lane], (steppedX >> lane) & 1, laneStepX[lane], laneStepY[lane], hits[lane])) {
+                        active &= ~(1 << lane);
+                    }
+                }
+            }
+
+            for (int lane = 0; lane < 4; ++lane) laneDistance[lane] = hits[lane].distance;
+            __m128 distance = _mm_load_ps(laneDistance);
+            __m128 perp = _mm_mul_ps(distance, _mm_add_ps(_mm_mul_ps(dirX, _mm_set1_ps(setup.viewDirection.x)), _mm_mul_ps(dirY, _mm_set1_ps(setup.viewDirection.y))));
+            __m128 corrected = _mm_max_ps(_mm_set1_ps(1.0f), perp);
+            __m128 height = _mm_div_ps(_mm_set1_ps(wallHeightScale), corrected);
+            __m128 brightness = _mm_max_ps(_mm_set1_ps(0.2f), _mm_sub_ps(_mm_set1_ps(1.0f), _mm_div_ps(corrected, _mm_set1_ps(wallShadeDistance))));
+            __m128i shade = _mm_cvttps_epi32(_mm_add_ps(_mm_set1_ps(50.0f), _mm_mul_ps(_mm_set1_ps(150.0f), brightness)));
+
+            alignas(16) float normalX[4], normalY[4], lanePerp[4], laneHeight[4];
+            alignas(16) int laneShade[4];
+            _mm_store_ps(normalX, dirX);
+            _mm_store_ps(normalY, dirY);
+            _mm_store_ps(lanePerp, perp);
+            _mm_store_ps(laneHeight, height);
+            _mm_store_si128(reinterpret_cast<__m128i*>(laneShade), shade);
+            for (int lane = 0; lane < 4; ++lane) {
+                storeLane(setup, hits[lane], normalX[lane], normalY[lane], lanePerp[lane], laneHeight[lane], laneShade[lane], columns[lane]);
+            }
+        }
+#endif
+
+#if RAYPACKET_HAS_AVX2
+        // 8 rays; only called after detectRayKernel confirmed AVX2 support
+        RAYPACKET_TARGET_AVX2 void castPacketAVX2(const PacketSetup& setup, const float* directionX, const float* directionY, WallColumn* columns) {
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 infinity = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+            const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+            __m256 dirX = _mm256_loadu_ps(directionX);
+            __m256 dirY = _mm256_loadu_ps(directionY);
+            __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dirX, dirX), _mm256_mul_ps(dirY, dirY)));
+            dirX = _mm256_div_ps(dirX, length);
+            dirY = _mm256_div_ps(dirY, length);
+
+            __m256 absX = _mm256_and_ps(dirX, absMask);
+            __m256 absY = _mm256_and_ps(dirY, absMask);
+            __m256 negativeX = _mm256_cmp_ps(dirX, zero, _CMP_LT_OQ);
+            __m256 negativeY = _mm256_cmp_ps(dirY, zero, _CMP_LT_OQ);
+            __m256i stepX = _mm256_or_si256(_mm256_castps_si256(negativeX), _mm256_andnot_si256(_mm256_castps_si256(negativeX), _mm256_set1_epi32(1)));
+            __m256i stepY = _mm256_or_si256(_mm256_castps_si256(negativeY), _mm256_andnot_si256(_mm256_castps_si256(negativeY), _mm256_set1_epi32(1)));
+
+            __m256 deltaX = _mm256_div_ps(_mm256_set1_ps(setup.tileWidth), absX);
+            __m256 deltaY = _mm256_div_ps(_mm256_set1_ps(setup.tileHeight), absY);
+            __m256 nextX = _mm256_blendv_ps(_mm256_set1_ps(setup.nextXPositive), _mm256_set1_ps(setup.nextXNegative), negativeX);
+            __m256 nextY = _mm256_blendv_ps(_mm256_set1_ps(setup.nextYPositive), _mm256_set1_ps(setup.nextYNegative), negativeY);
+            __m256 sideX = _mm256_blendv_ps(_mm256_div_ps(nextX, absX), infinity, _mm256_cmp_ps(dirX, zero, _CMP_EQ_OQ));
+            __m256 sideY = _mm256_blendv_ps(_mm256_div_ps(nextY, absY), infinity, _mm256_cmp_ps(dirY, zero, _CMP_EQ_OQ));
+            __m256i cellX = _mm256_set1_epi32(static_cast<int>(setup.cellX));
+            __m256i cellY = _mm256_set1_epi32(static_cast<int>(setup.cellY));
+
+            alignas(32) float laneDistance[8];
+            alignas(32) int laneCellX[8], laneCellY[8], laneStepX[8], laneStepY[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(laneStepX), stepX);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(laneStepY), stepY);
+
+            RayHit hits[8];
+            int active = 0xFF;
+            while (active) {
+                __m256 chooseX = _mm256_cmp_ps(sideX, sideY, _CMP_LT_OQ);
+                __m256i chooseXi = _mm256_castps_si256(chooseX);
+                __m256 distance = _mm256_blendv_ps(sideY, sideX, chooseX);
+                sideX = _mm256_add_ps(sideX, _mm256_and_ps(chooseX, deltaX));
+                sideY = _mm256_add_ps(sideY, _mm256_andnot_ps(chooseX, deltaY));
+                cellX = _mm256_add_epi32(cellX, _mm256_and_si256(chooseXi, stepX));
+                cellY = _mm256_add_epi32(cellY, _mm256_andnot_si256(chooseXi, stepY));
+
+                _mm256_store_ps(laneDistance, distance);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(laneCellX), cellX);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(laneCellY), cellY);
+                int steppedX = _mm256_movemask_ps(chooseX);
+                _mm256_zeroupper(); // finishLane is plain SSE code; avoids the AVX to SSE transition stall in unoptimized builds
+
+                for (int lane = 0; lane < 8; ++lane) {
+                    if (!(active & (1 << lane))) continue; // lane already terminated, keep its result
+                    if (finishLane(setup, laneDistance[lane], laneCellX[lane], laneCellY[lane], (steppedX >> lane) & 1, laneStepX[lane], laneStepY[lane], hits[lane])) {
+                        active &= ~(1 << lane);
+                    }
+                }
+            }
+
+            for (int lane = 0; lane < 8; ++lane) laneDistance[lane] = hits[lane].distance;
+            __m256 distance = _mm256_load_ps(laneDistance);
+            __m256 perp = _mm256_mul_ps(distance, _mm256_add_ps(_mm256_mul_ps(dirX, _mm256_set1_ps(setup.viewDirection.x)), _mm256_mul_ps(dirY, _mm256_set1_ps(setup.viewDirection.y))));
+            __m256 corrected = _mm256_max_ps(_mm256_set1_ps(1.0f), perp);
+            __m256 height = _mm256_div_ps(_mm256_set1_ps(wallHeightScale), corrected);
+            __m256 brightness = _mm256_max_ps(_mm256_set1_ps(0.2f), _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_div_ps(corrected, _mm256_set1_ps(wallShadeDistance))));
+            __m256i shade = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_set1_ps(50.0f), _mm256_mul_ps(_mm256_set1_ps(150.0f), brightness)));
+
+            alignas(32) float normalX[8], normalY[8], lanePerp[8], laneHeight[8];
+            alignas(32) int laneShade[8];
+            _mm256_store_ps(normalX, dirX);
+            _mm256_store_ps(normalY, dirY);
+            _mm256_store_ps(lanePerp, perp);
+            _mm256_store_ps(laneHeight, height);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(laneShade), shade);
+            _mm256_zeroupper();
+            for (int lane = 0; lane < 8; ++lane) {
+                storeLane(setup, hits[lane], normalX[lane], normalY[lane], lanePerp[lane], laneHeight[lane], laneShade[lane], columns[lane]);
+            }
+        }
+#endif
+    }
+
+    RayKernel detectRayKernel() {
+        static const RayKernel kernel = [] {
+#if RAYPACKET_HAS_AVX2
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return RayKernel::AVX2;
+#endif
+#if RAYPACKET_X86
+            return RayKernel::SSE;
+#else
+            return RayKernel::SCALAR;
+#endif
+        }();
+        return kernel;
+    }
+
+    std::string rayKernelName(RayKernel kernel) {
+        switch (kernel) {
+            case RayKernel::AVX2: return "AVX2 (8 rays)";
+            case RayKernel::SSE: return "SSE (4 rays)";
+            default: return "scalar";
+        }
+    }
+
+    void castRayPacket(const TileMap& tileMap, sf::Vector2f origin, const float* directionX, const float* directionY, size_t count,
+                       sf::Vector2f viewDirection, float maxDistance, WallColumn* columns, RayKernel kernel) {
+        PacketSetup setup = makeSetup(tileMap, origin, viewDirection, maxDistance);
+        size_t i = 0;
+
+#if RAYPACKET_HAS_AVX2
+        if (kernel == RayKernel::AVX2) {
+            for (; i + 8 <= count; i += 8) {
+                if (hasZeroDirection(directionX + i, directionY + i, 8)) castScalar(setup, directionX + i, directionY + i, 8, columns + i);
+                else castPacketAVX2(setup, directionX + i, directionY + i, columns + i);
+            }
+        }
+#endif
+#if RAYPACKET_X86
+        if (kernel != RayKernel::SCALAR) {
+            for (; i + 4 <= count; i += 4) {
+                if (hasZeroDirection(directionX + i, directionY + i, 4)) castScalar(setup, directionX + i, directionY + i, 4, columns + i);
+                else castPacketSSE(setup, directionX + i, directionY + i, columns + i);
+            }
+        }
+#endif
+        castScalar(setup, directionX + i, directionY + i, count - i, columns + i);
+    }
+}
@@ -0,0 +1,22 @@
+//
+//  raypacket.hpp
+//
+//
+
+#pragma once
+
+#include "raycast.hpp"
+
+namespace physics {
+    // instruction set used to step rays through the grid; picked at runtime from what the CPU supports
+    enum class RayKernel { SCALAR, SSE, AVX2 };
+
+    RayKernel detectRayKernel(); // widest kernel this CPU can run (cached after the first call)
+    std::string rayKernelName(RayKernel kernel);
+
+    /* casts count rays from the same origin. Rays are walked through the grid in lockstep packets of 4 (SSE) or 8 (AVX2)
+    lanes, lanes that terminated are masked out until the whole packet is done, then distance, wall height and shade are
+    computed for the packet at once. Leftover rays and non-x86 builds use the scalar castRay. directions don't need to be normalized */
+    void castRayPacket(const TileMap& tileMap, sf::Vector2f origin, const float* directionX, const float* directionY, size_t count,
+                       sf::Vector2f viewDirection, float maxDistance, WallColumn* columns, RayKernel kernel = detectRayKernel());
+}
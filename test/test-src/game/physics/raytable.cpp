@@ -0,0 +1,43 @@
+//
+//  raytable.cpp
+//
+//
+
+#include "raytable.hpp"
+
+#include <cmath>
+
+namespace physics {
+    bool RayTable::update(float fov, size_t rayCount, sf::Vector2f viewSize) {
+        if (fov == this->fov && rayCount == getRayCount() && viewSize == this->viewSize) return false;
+        rebuild(fov, rayCount, viewSize);
+        return true;
+    }
+
+    void RayTable::rebuild(float fov, size_t rayCount, sf::Vector2f viewSize) {
+        ScopedTimer timer("RayTable rebuild (" + std::to_string(rayCount) + " columns)");
+
+        this->fov = fov;
+        this->viewSize = viewSize;
+        angleStep = rayCount ? fov / static_cast<float>(rayCount) : 0.0f; // Angle step between rays
+        sliceWidth = rayCount ? viewSize.x / static_cast<float>(rayCount) : 0.0f;
+
+        // double precision so the fan stays symmetric and equiangular; this only runs when the inputs change
+        const double degToRad = 3.14159265358979323846 / 180.0;
+        double halfPlane = std::tan(fov / 2.0 * degToRad);
+        planeScale = static_cast<float>(halfPlane);
+
+        cameraOffsets.resize(rayCount);
+        fisheyeFactors.resize(rayCount);
+        screenX.resize(rayCount);
+        for (size_t i = 0; i < rayCount; ++i) {
+            double angle = (static_cast<double>(i) - rayCount / 2.0) * angleStep * degToRad; // angle from the view direction
+            cameraOffsets[i] = halfPlane != 0.0 ? static_cast<float>(std::tan(angle) / halfPlane) : 0.0f;
+            fisheyeFactors[i] = static_cast<float>(std::cos(angle));
+            screenX[i] = i * sliceWidth;
+        }
+
+        log_info("RayTable built for FOV " + std::to_string(fov) + ", " + std::to_string(rayCount) + " columns, view " +
+                 std::to_string(viewSize.x) + "x" + std::to_string(viewSize.y) + " (" + std::to_string(3 * rayCount * sizeof(float)) + " bytes)");
+    }
+}
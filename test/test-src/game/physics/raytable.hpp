@@ -0,0 +1,48 @@
+//
+//  raytable.hpp
+//
+//
+
+#pragma once
+
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "../globals/globals.hpp"
+
+namespace physics {
+    /* per-column values of the ray fan that only depend on FOV, ray count and view size. Column i looks angleStep degrees
+    further than column i - 1, its direction is viewDirection + cameraPlane * cameraOffset[i] where the camera plane is the
+    view direction turned 90 degrees and scaled by tan(FOV / 2), so building a frame's rays needs no trig */
+    class RayTable {
+    public:
+        bool update(float fov, size_t rayCount, sf::Vector2f viewSize); // rebuilds only if one of the inputs changed, returns true if it did
+        void rebuild(float fov, size_t rayCount, sf::Vector2f viewSize);
+
+        size_t getRayCount() const { return cameraOffsets.size(); }
+        float getFov() const { return fov; }
+        float getAngleStep() const { return angleStep; } // degrees between neighbouring columns
+        float getPlaneScale() const { return planeScale; } // tan(FOV / 2), length of the camera plane vector
+        float getSliceWidth() const { return sliceWidth; } // screen width of one column
+        sf::Vector2f getViewSize() const { return viewSize; }
+
+        float getCameraOffset(size_t column) const { return cameraOffsets[column]; } // -1 at the left edge, 1 at the right edge
+        float getFisheyeFactor(size_t column) const { return fisheyeFactors[column]; } // cos of the column's angle from the view direction
+        float getScreenX(size_t column) const { return screenX[column]; } // left edge of the column on screen
+        sf::Vector2f getCameraPlane(sf::Vector2f viewDirection) const { return sf::Vector2f(-viewDirection.y, viewDirection.x) * planeScale; }
+
+        // direction of a column's ray (not normalized, its length is 1 / fisheye factor)
+        sf::Vector2f getRayDirection(size_t column, sf::Vector2f viewDirection, sf::Vector2f cameraPlane) const { return viewDirection + cameraPlane * cameraOffsets[column]; }
+
+    private:
+        float fov = -1.0f;
+        float angleStep {};
+        float planeScale {};
+        float sliceWidth {};
+        sf::Vector2f viewSize {};
+
+        std::vector<float> cameraOffsets;
+        std::vector<float> fisheyeFactors;
+        std::vector<float> screenX;
+    };
+}
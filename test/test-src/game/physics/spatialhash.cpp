@@ -0,0 +1,139 @@
+//
+//  spatialhash.cpp
+//
+//
+
+#include "spatialhash.hpp"
+#include "bucketsort.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace physics {
+    SpatialHash::SpatialHash(sf::Vector2f origin, float cellWidth, float cellHeight)
+        : origin(origin), cellWidth(cellWidth > 0.0f ? cellWidth : 1.0f), cellHeight(cellHeight > 0.0f ? cellHeight : 1.0f) {
+        bucketStarts.assign(2, 0);
+    }
+
+    int32_t SpatialHash::cellX(float x) const {
+        float cell = std::floor((x - origin.x) / cellWidth);
+        return static_cast<int32_t>(std::clamp(cell, -1e9f, 1e9f));
+    }
+
+    int32_t SpatialHash::cellY(float y) const {
+        float cell = std::floor((y - origin.y) / cellHeight);
+        return static_cast<int32_t>(std::clamp(cell, -1e9f, 1e9f));
+    }
+
+    size_t SpatialHash::bucketOf(int32_t x, int32_t y) const {
+        // the grid wrapped onto a bucketsX-wide torus: neighbouring cells stay in neighbouring buckets, which keeps the items they hold close in memory
+        return (static_cast<uint32_t>(x) & (bucketsX - 1)) + (static_cast<size_t>(static_cast<uint32_t>(y) & (bucketsY - 1)) << bucketShiftX);
+    }
+
+    void SpatialHash::insert(Sprite* sprite) {
+        if (!sprite) {
+            log_warning("Tried to insert a null sprite into the spatial hash");
+            return;
+        }
+        sprites.push_back(sprite);
+    }
+
+    void SpatialHash::remove(Sprite* sprite) {
+        removeFromBuckets(sprite, sprites, bucketStarts, items);
+    }
+
+    void SpatialHash::clear() {
+        sprites.clear();
+        items.clear();
+        std::fill(bucketStarts.begin(), bucketStarts.end(), 0);
+    }
+
+    void SpatialHash::update() {
+        try {
+            bucketShiftX = 3;
+            bucketsY = 8;
+            while ((size_t(1) << bucketShiftX) * bucketsY < sprites.size() * 2) {
+                if (bucketsY < (size_t(1) << bucketShiftX)) bucketsY *= 2;
+                else ++bucketShiftX;
+            }
+            bucketsX = size_t(1) << bucketShiftX;
+
+            // every sprite under the bucket of the cell holding its centre
+            unsorted.resize(sprites.size());
+            itemBuckets.resize(sprites.size());
+            float widest = 0.0f, tallest = 0.0f;
+            for (size_t i = 0; i < sprites.size(); ++i) {
+                sf::FloatRect bounds = sprites[i]->returnSpritesShape().getGlobalBounds();
+                widest = std::max(widest, bounds.width);
+                tallest = std::max(tallest, bounds.height);
+                Item& item = unsorted[i];
+                item = { sprites[i], bounds, cellX(bounds.left + bounds.width / 2.0f), cellY(bounds.top + bounds.height / 2.0f) };
+                itemBuckets[i] = static_cast<uint32_t>(bucketOf(item.cellX, item.cellY));
+            }
+            reachX = widest / 2.0f;
+            reachY = tallest / 2.0f;
+            sortByBucket(itemBuckets, bucketsX * bucketsY, [this](size_t i) { return unsorted[i]; }, bucketStarts, items);
+        } catch (const std::exception& e) {
+            log_error("Error during spatial hash update: " + std::string(e.what()));
+        }
+    }
+
+    template<typename Visit>
+    void SpatialHash::forEachInCells(const sf::FloatRect& area, const Visit& visit) const {
+        if (items.empty()) return;
+        int32_t left = cellX(area.left - reachX), right = cellX(area.left + area.width + reachX);
+        int32_t top = cellY(area.top - reachY), bottom = cellY(area.top + area.height + reachY);
+
+        // an area covering more cells than there are sprites is cheaper to answer by testing every sprite once
+        double cellCount = (static_cast<double>(right) - left + 1) * (static_cast<double>(bottom) - top + 1);
+        if (cellCount > static_cast<double>(items.size())) {
+            for (const Item& item : items) {
+                if (item.cellX >= left && item.cellX <= right && item.cellY >= top && item.cellY <= bottom) visit(item);
+            }
+            return;
+        }
+
+        for (int32_t y = top; y <= bottom; ++y) {
+            for (int32_t x = left; x <= right; ++x) {
+                size_t bucket = bucketOf(x, y);
+                for (uint32_t i = bucketStarts[bucket]; i < bucketStarts[bucket + 1]; ++i) {
+                    if (items[i].cellX == x && items[i].cellY == y) visit(items[i]); // other cells can share the bucket
+                }
+            }
+        }
+    }
+
+    void SpatialHash::query(const sf::FloatRect& area, std::vector<Sprite*>& result) const {
+        forEachInCells(area, [&](const Item& item) {
+            if (area.intersects(item.bounds)) result.push_back(item.sprite);
+        });
+    }
+
+    void SpatialHash::queryFrustum(const ViewFrustum& frustum, std::vector<Sprite*>& result) const {
+        forEachInCells(frustum.getBounds(), [&](const Item& item) {
+            if (frustum.intersects(item.bounds)) result.push_back(item.sprite);
+        });
+    }
+
+    void SpatialHash::findPairs(std::vector<std::pair<Sprite*, Sprite*>>& pairs) const {
+        // overlapping sprites have centres at most the largest sprite apart, so only that many cells around each one are looked at
+        int32_t rangeX = static_cast<int32_t>(std::ceil(2.0f * reachX / cellWidth));
+        int32_t rangeY = static_cast<int32_t>(std::ceil(2.0f * reachY / cellHeight));
+
+        for (uint32_t i = 0; i < items.size(); ++i) {
+            const Item& item = items[i];
+            // each pair once: later items of the same cell, then only the cells after this one in row order
+            for (int32_t dy = 0; dy <= rangeY; ++dy) {
+                for (int32_t dx = dy == 0 ? 0 : -rangeX; dx <= rangeX; ++dx) {
+                    int32_t x = item.cellX + dx, y = item.cellY + dy;
+                    size_t bucket = bucketOf(x, y);
+                    uint32_t first = dx == 0 && dy == 0 ? i + 1 : bucketStarts[bucket];
+                    for (uint32_t j = first; j < bucketStarts[bucket + 1]; ++j) {
+                        const Item& other = items[j];
+                        if (other.cellX == x && other.cellY == y && item.bounds.intersects(other.bounds)) pairs.emplace_back(item.sprite, other.sprite);
+                    }
+                }
+            }
+        }
+    }
+}
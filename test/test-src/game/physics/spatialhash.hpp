@@ -0,0 +1,66 @@
+//
+//  spatialhash.hpp
+//
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "broadphase.hpp"
+
+namespace physics {
+    /* uniform grid broadphase for sprites about the size of a tile. Cells are cellWidth x cellHeight from origin, so with
+    the tile size and the tile map's position they line up with the map's cells, and the grid is unbounded: cells are
+    hashed by wrapping them onto a power of two grid of buckets (at least twice the sprite count) instead of being stored.
+    update() files every sprite under the cell holding its centre with a counting sort by bucket, O(n) and no
+    allocation once the buffers have grown. A sprite only reaches half its size out of its cell, so queries widen the
+    area by half the largest sprite and check the cells in it; sprites of other cells sharing a bucket are skipped */
+    class SpatialHash : public Broadphase {
+    public:
+        SpatialHash(sf::Vector2f origin, float cellWidth, float cellHeight);
+
+        using Broadphase::insert;
+        void insert(Sprite* sprite) override;
+        void remove(Sprite* sprite) override; // O(n)
+        void clear() override;
+        void update() override;
+
+        void query(const sf::FloatRect& area, std::vector<Sprite*>& result) const override;
+        void queryFrustum(const ViewFrustum& frustum, std::vector<Sprite*>& result) const override;
+        void findPairs(std::vector<std::pair<Sprite*, Sprite*>>& pairs) const override;
+        size_t getSpriteCount() const override { return sprites.size(); }
+
+        size_t getBucketCount() const { return bucketsX * bucketsY; }
+
+    private:
+        struct Item {
+            Sprite* sprite;
+            sf::FloatRect bounds; // as of the last update
+            int32_t cellX;
+            int32_t cellY;
+        };
+
+        int32_t cellX(float x) const;
+        int32_t cellY(float y) const;
+        size_t bucketOf(int32_t x, int32_t y) const;
+        template<typename Visit> void forEachInCells(const sf::FloatRect& area, const Visit& visit) const; // items of the cells the widened area covers
+
+        sf::Vector2f origin;
+        float cellWidth;
+        float cellHeight;
+        float reachX {}; // half the widest and tallest sprite of the last update
+        float reachY {};
+
+        std::vector<Sprite*> sprites; // everything inserted, in insertion order
+        std::vector<uint32_t> itemBuckets; // bucket of sprites[i], filled by update
+        std::vector<Item> unsorted;
+        size_t bucketsX = 8; // powers of two
+        size_t bucketsY = 8;
+        size_t bucketShiftX = 3;
+        std::vector<uint32_t> bucketStarts; // bucket b owns items [bucketStarts[b], bucketStarts[b + 1])
+        std::vector<Item> items; // sorted by bucket
+    };
+}
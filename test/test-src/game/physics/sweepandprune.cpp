@@ -0,0 +1,249 @@
+//
+//  sweepandprune.cpp
+//
+//
+
+#include "sweepandprune.hpp"
+
+#include <algorithm>
+
+namespace physics {
+    void SweepAndPrune::insert(Sprite* sprite) {
+        if (!sprite) {
+            log_warning("Tried to insert a null sprite into sweep and prune");
+            return;
+        }
+        if (proxyIds.count(sprite)) {
+            log_warning("Tried to insert a sprite into sweep and prune twice");
+            return;
+        }
+
+        uint32_t id;
+        if (!freeProxies.empty()) {
+            id = freeProxies.back();
+            freeProxies.pop_back();
+        } else {
+            id = static_cast<uint32_t>(proxies.size());
+            proxies.emplace_back();
+        }
+        proxies[id] = Proxy();
+        proxies[id].sprite = sprite;
+        proxyIds.emplace(sprite, id);
+        insertedProxies.push_back(id);
+        ++spriteCount;
+    }
+
+    void SweepAndPrune::remove(Sprite* sprite) {
+        auto found = proxyIds.find(sprite);
+        if (found == proxyIds.end()) return;
+        uint32_t id = found->second;
+        proxyIds.erase(found);
+        --spriteCount;
+
+        auto inserted = std::find(insertedProxies.begin(), insertedProxies.end(), id);
+        if (inserted != insertedProxies.end()) { // never made it into the lists, nothing to end
+            insertedProxies.erase(inserted);
+            proxies[id] = Proxy();
+            freeProxies.push_back(id);
+            return;
+        }
+
+        auto ofProxy = [id](const Endpoint& endpoint) { return endpoint.proxy() == id; };
+        endpointsX.erase(std::remove_if(endpointsX.begin(), endpointsX.end(), ofProxy), endpointsX.end());
+        endpointsY.erase(std::remove_if(endpointsY.begin(), endpointsY.end(), ofProxy), endpointsY.end());
+        for (size_t i = pairs.size(); i-- > 0;) {
+            uint32_t a = static_cast<uint32_t>(pairs[i] >> 32), b = static_cast<uint32_t>(pairs[i]);
+            if (a == id || b == id) removePair(a, b);
+        }
+
+        proxies[id].removed = true;
+        removedProxies.push_back(id); // the id isn't reused before the end events went out
+    }
+
+    void SweepAndPrune::clear() {
+        proxies.clear();
+        proxyIds.clear();
+        freeProxies.clear();
+        removedProxies.clear();
+        insertedProxies.clear();
+        endpointsX.clear();
+        endpointsY.clear();
+        pairSlots.clear();
+        pairs.clear();
+        changedPairs.clear();
+        events.clear();
+        spriteCount = 0;
+    }
+
+    void SweepAndPrune::addPair(uint32_t a, uint32_t b) {
+        uint64_t key = pairKey(a, b);
+        if (pairSlots.count(key)) return;
+        changedPairs.emplace(key, false); // keeps the first state of this frame
+        pairSlots.emplace(key, static_cast<uint32_t>(pairs.size()));
+        pairs.push_back(key);
+    }
+
+    void SweepAndPrune::removePair(uint32_t a, uint32_t b) {
+        uint64_t key = pairKey(a, b);
+        auto found = pairSlots.find(key);
+        if (found == pairSlots.end()) return;
+        changedPairs.emplace(key, true);
+
+        uint32_t slot = found->second;
+        pairSlots.erase(found);
+        if (slot + 1 != pairs.size()) {
+            pairs[slot] = pairs.back(); // the last pair takes the freed slot
+            pairSlots[pairs[slot]] = slot;
+        }
+        pairs.pop_back();
+    }
+
+    void SweepAndPrune::refreshEndpoints(std::vector<Endpoint>& axis, bool horizontal) {
+        for (Endpoint& endpoint : axis) {
+            const sf::FloatRect& bounds = proxies[endpoint.proxy()].bounds;
+            float low = horizontal ? bounds.left : bounds.top;
+            float high = low + (horizontal ? bounds.width : bounds.height);
+            endpoint.value = endpoint.isMin() ? low : high;
+            endpoint.opposite = endpoint.isMin() ? high : low;
+            endpoint.crossMin = horizontal ? bounds.top : bounds.left;
+            endpoint.crossMax = endpoint.crossMin + (horizontal ? bounds.height : bounds.width);
+        }
+    }
+
+    void SweepAndPrune::sortAxis(std::vector<Endpoint>& axis) {
+        for (size_t i = 1; i < axis.size(); ++i) {
+            Endpoint moving = axis[i];
+            size_t j = i;
+            // moving passes every end before it that it now sorts before, one swap each
+            for (; j > 0 && moving.before(axis[j - 1]); --j) {
+                const Endpoint& passed = axis[j - 1];
+                axis[j] = passed;
+                ++swaps;
+                // a min now below the other's max: they may overlap on this axis, the rest of the bounds decides.
+                // A max falling below a min separates them, those pairs are dropped after sorting
+                if (moving.isMin() && !passed.isMin() && moving.proxy() != passed.proxy() && moving.overlaps(passed)) addPair(moving.proxy(), passed.proxy());
+            }
+            axis[j] = moving;
+        }
+    }
+
+    void SweepAndPrune::rebuild() {
+        auto less = [](const Endpoint& a, const Endpoint& b) { return a.before(b); };
+        std::sort(endpointsX.begin(), endpointsX.end(), less);
+        std::sort(endpointsY.begin(), endpointsY.end(), less);
+
+        // sweep x keeping the sprites whose range is open; the ones a new min meets overlap on x, y decides
+        std::vector<uint64_t> found;
+        active.clear();
+        for (const Endpoint& endpoint : endpointsX) {
+            uint32_t id = endpoint.proxy();
+            if (!endpoint.isMin()) {
+                active.erase(std::find(active.begin(), active.end(), id));
+                continue;
+            }
+            for (uint32_t other : active) {
+                if (overlaps(id, other)) found.push_back(pairKey(id, other));
+            }
+            active.push_back(id);
+        }
+
+        std::sort(found.begin(), found.end());
+        for (size_t i = pairs.size(); i-- > 0;) {
+            if (!std::binary_search(found.begin(), found.end(), pairs[i])) removePair(static_cast<uint32_t>(pairs[i] >> 32), static_cast<uint32_t>(pairs[i]));
+        }
+        for (uint64_t key : found) addPair(static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key));
+    }
+
+    void SweepAndPrune::update() {
+        try {
+            swaps = 0;
+            widest = 0.0f;
+            for (Proxy& proxy : proxies) {
+                if (!proxy.sprite || proxy.removed) continue;
+                proxy.bounds = proxy.sprite->returnSpritesShape().getGlobalBounds();
+                widest = std::max(widest, proxy.bounds.width);
+            }
+            // new ends go behind every other one, as if the sprite came from far away; sorting moves them in and finds its pairs
+            for (uint32_t id : insertedProxies) {
+                endpointsX.push_back({ 0.0f, id << 1 | 1u });
+                endpointsX.push_back({ 0.0f, id << 1 });
+                endpointsY.push_back({ 0.0f, id << 1 | 1u });
+                endpointsY.push_back({ 0.0f, id << 1 });
+            }
+            refreshEndpoints(endpointsX, true);
+            refreshEndpoints(endpointsY, false);
+
+            // inserting a lot at once is quadratic for insertion sort, sort and sweep everything instead
+            if (insertedProxies.size() > spriteCount / 4 + 16) rebuild();
+            else {
+                sortAxis(endpointsX);
+                sortAxis(endpointsY);
+                for (size_t i = pairs.size(); i-- > 0;) {
+                    uint32_t a = static_cast<uint32_t>(pairs[i] >> 32), b = static_cast<uint32_t>(pairs[i]);
+                    if (!overlaps(a, b)) removePair(a, b);
+                }
+            }
+            insertedProxies.clear();
+
+            buildEvents();
+            changedPairs.clear();
+            for (uint32_t id : removedProxies) {
+                proxies[id] = Proxy();
+                freeProxies.push_back(id);
+            }
+            removedProxies.clear();
+        } catch (const std::exception& e) {
+            log_error("Error during sweep and prune update: " + std::string(e.what()));
+        }
+    }
+
+    void SweepAndPrune::buildEvents() {
+        events.clear();
+        auto sprites = [this](uint64_t key) { return std::make_pair(proxies[key >> 32].sprite, proxies[static_cast<uint32_t>(key)].sprite); };
+
+        for (uint64_t key : pairs) {
+            auto changed = changedPairs.find(key);
+            OverlapPhase phase = changed != changedPairs.end() && !changed->second ? OverlapPhase::BEGIN : OverlapPhase::PERSIST;
+            if (phase == OverlapPhase::BEGIN) events.push_back({ sprites(key).first, sprites(key).second, phase });
+        }
+        for (uint64_t key : pairs) {
+            auto changed = changedPairs.find(key);
+            if (changed == changedPairs.end() || changed->second) events.push_back({ sprites(key).first, sprites(key).second, OverlapPhase::PERSIST });
+        }
+        for (const auto& [key, existed] : changedPairs) {
+            if (existed && !pairSlots.count(key)) events.push_back({ sprites(key).first, sprites(key).second, OverlapPhase::END });
+        }
+    }
+
+    template<typename Test>
+    void SweepAndPrune::scan(const sf::FloatRect& area, const Test& test, std::vector<Sprite*>& result) const {
+        // min ends up to the area's right edge (a frustum counts touching rects), back to where even the widest sprite can't reach the area
+        Endpoint right { area.left + area.width, 1u };
+        auto end = std::upper_bound(endpointsX.begin(), endpointsX.end(), right, [](const Endpoint& a, const Endpoint& b) { return a.before(b); });
+        for (auto it = end; it != endpointsX.begin();) {
+            --it;
+            if (it->value + widest < area.left) break;
+            if (!it->isMin()) continue;
+            const Proxy& proxy = proxies[it->proxy()];
+            if (test(proxy.bounds)) result.push_back(proxy.sprite);
+        }
+    }
+
+    void SweepAndPrune::query(const sf::FloatRect& area, std::vector<Sprite*>& result) const {
+        scan(area, [&area](const sf::FloatRect& rect) { return area.intersects(rect); }, result);
+    }
+
+    void SweepAndPrune::queryFrustum(const ViewFrustum& frustum, std::vector<Sprite*>& result) const {
+        scan(frustum.getBounds(), [&frustum](const sf::FloatRect& rect) { return frustum.intersects(rect); }, result);
+    }
+
+    void SweepAndPrune::findPairs(std::vector<std::pair<Sprite*, Sprite*>>& result) const {
+        for (uint64_t key : pairs) result.emplace_back(proxies[key >> 32].sprite, proxies[static_cast<uint32_t>(key)].sprite);
+    }
+
+    bool SweepAndPrune::mayOverlap(const Sprite& a, const Sprite& b) const {
+        auto first = proxyIds.find(&a), second = proxyIds.find(&b);
+        if (first == proxyIds.end() || second == proxyIds.end()) return false;
+        return pairSlots.count(pairKey(first->second, second->second)) > 0;
+    }
+}
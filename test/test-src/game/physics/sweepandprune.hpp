@@ -0,0 +1,95 @@
+//
+//  sweepandprune.hpp
+//
+//
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "broadphase.hpp"
+
+namespace physics {
+    /* incremental sweep and prune: the min and max ends of every sprite's bounds are kept sorted on the x and the y axis
+    between frames. update() refreshes the ends and re-sorts both lists with insertion sort, which for sprites that moved
+    a little is close to O(n). A min passing a max in a swap is where an overlap on that axis can start, only those pairs
+    are tested for new overlaps; the pairs already in the set are checked once more and dropped once apart. That keeps
+    the set up to date in O(n + swaps + pairs) instead of rebuilding it. Ends touching count as apart, like
+    sf::FloatRect::intersects.
+    The pair set persists across frames and update() reports what changed as begin / persist / end events. Inserting
+    many sprites at once falls back to a full sort and sweep. Removed sprites get their end events in the next update
+    and their pointer is passed on as is, it may already be destroyed; one removed and inserted again within a frame
+    ends its pairs and begins them anew */
+    class SweepAndPrune : public Broadphase {
+    public:
+        using Broadphase::insert;
+        void insert(Sprite* sprite) override;
+        void remove(Sprite* sprite) override;
+        void clear() override;
+        void update() override;
+
+        void query(const sf::FloatRect& area, std::vector<Sprite*>& result) const override;
+        void queryFrustum(const ViewFrustum& frustum, std::vector<Sprite*>& result) const override;
+        void findPairs(std::vector<std::pair<Sprite*, Sprite*>>& pairs) const override; // the persistent set, no test needed
+        bool mayOverlap(const Sprite& a, const Sprite& b) const override; // a lookup in the pair set, O(1)
+        size_t getSpriteCount() const override { return spriteCount; }
+
+        const std::vector<OverlapEvent>* getOverlapEvents() const override { return &events; } // begins, persists, then ends
+        size_t getSwapCount() const { return swaps; } // endpoint swaps of the last update, low for coherent motion
+
+    private:
+        struct Proxy {
+            Sprite* sprite = nullptr; // null once the slot is free
+            sf::FloatRect bounds; // as of the last update
+            bool removed = false; // kept until the next update so its end events can name it
+        };
+
+        /* one end of a proxy's bounds on an axis; ordered by value, at equal values max ends first so touching isn't overlapping.
+        It carries the rest of the bounds too, so testing the two ends of a swap doesn't have to look up either proxy */
+        struct Endpoint {
+            float value;
+            uint32_t data; // proxy << 1 | 1 for a min end
+            float opposite; // the proxy's other end on this axis
+            float crossMin; // the proxy's extent on the other axis
+            float crossMax;
+            uint32_t proxy() const { return data >> 1; }
+            bool isMin() const { return data & 1u; }
+            float low() const { return isMin() ? value : opposite; }
+            float high() const { return isMin() ? opposite : value; }
+            bool before(const Endpoint& other) const { return value < other.value || (value == other.value && (data & 1u) < (other.data & 1u)); }
+            bool crosses(const Endpoint& other) const { return crossMin < other.crossMax && other.crossMin < crossMax; }
+            bool overlaps(const Endpoint& other) const { return low() < other.high() && other.low() < high() && crosses(other); }
+        };
+
+        static uint64_t pairKey(uint32_t a, uint32_t b) { return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a; }
+        bool overlaps(uint32_t a, uint32_t b) const { return proxies[a].bounds.intersects(proxies[b].bounds); }
+        void addPair(uint32_t a, uint32_t b);
+        void removePair(uint32_t a, uint32_t b);
+        void sortAxis(std::vector<Endpoint>& axis); // insertion sort, adds the pairs a min passing a max made overlap
+        void rebuild(); // full sort of both axes and a sweep over x, for many new sprites
+        void refreshEndpoints(std::vector<Endpoint>& axis, bool horizontal);
+        template<typename Test> void scan(const sf::FloatRect& area, const Test& test, std::vector<Sprite*>& result) const;
+        void buildEvents();
+
+        std::vector<Proxy> proxies; // indexed by proxy id
+        std::unordered_map<const Sprite*, uint32_t> proxyIds; // of every inserted sprite that wasn't removed
+        std::vector<uint32_t> freeProxies;
+        std::vector<uint32_t> removedProxies; // freed at the end of the next update
+        size_t spriteCount {};
+        std::vector<uint32_t> insertedProxies; // get their ends at the next update, queries until then don't see them
+        float widest {}; // largest width of the last update, bounds how far back a query has to look
+
+        std::vector<Endpoint> endpointsX;
+        std::vector<Endpoint> endpointsY;
+        size_t swaps {};
+
+        std::unordered_map<uint64_t, uint32_t> pairSlots; // pair key to index in pairs
+        std::vector<uint64_t> pairs;
+        std::unordered_map<uint64_t, bool> changedPairs; // pairs added or removed since the last update, and if they existed before
+        std::vector<OverlapEvent> events;
+        std::vector<uint32_t> active; // rebuild's sweep
+    };
+}
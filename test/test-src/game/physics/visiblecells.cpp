@@ -0,0 +1,108 @@
+//
+//  visiblecells.cpp
+//
+//
+
+#include "visiblecells.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace physics {
+    void VisibleCells::begin(const TileMap& tileMap, sf::Vector2f origin, float maxDistance) {
+        position = tileMap.getTileMapPosition();
+        tileSize = { tileMap.getTileWidth(), tileMap.getTileHeight() };
+
+        // a ray walks at most maxDistance / tile cells from the origin's cell, plus the one it ends in
+        float smallestTile = std::max(std::min(tileSize.x, tileSize.y), 1e-3f);
+        size_t radius = static_cast<size_t>(std::ceil(maxDistance / smallestTile)) + 1;
+        size_t newWindowSize = 2 * radius + 1;
+        if (!isBuiltFor(tileMap) || newWindowSize != windowSize) {
+            mapId = tileMap.getMapId();
+            width = tileMap.getTileMapWidth();
+            height = tileMap.getTileMapHeight();
+            windowSize = newWindowSize;
+            stamps.assign(windowSize * windowSize, 0);
+            generation = 0;
+        }
+        sf::Vector2f local = origin - position;
+        windowX = static_cast<size_t>(static_cast<long>(std::floor(local.x / std::max(tileSize.x, 1e-3f)))) - radius; // origin's cell in the middle
+        windowY = static_cast<size_t>(static_cast<long>(std::floor(local.y / std::max(tileSize.y, 1e-3f)))) - radius;
+
+        if (++generation == 0) { // wrapped, old stamps would read as visible again
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+        cells.clear();
+    }
+
+    void VisibleCells::markCell(size_t x, size_t y) {
+        if (!inWindow(x, y)) return;
+        size_t index = stampIndex(x, y);
+        if (stamps[index] == generation) return;
+        stamps[index] = generation;
+        cells.push_back(static_cast<uint32_t>(y * width + x));
+    }
+
+    void VisibleCells::markRay(const TileMap& tileMap, sf::Vector2f origin, sf::Vector2f direction, float distance) {
+        // the same grid walk as castRay, without the map lookups
+        float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+        if (length == 0.0f || tileSize.x <= 0.0f || tileSize.y <= 0.0f) return;
+        direction /= length;
+
+        sf::Vector2f local = origin - position;
+        long cellX = static_cast<long>(std::floor(local.x / tileSize.x));
+        long cellY = static_cast<long>(std::floor(local.y / tileSize.y));
+        long mapWidth = static_cast<long>(width), mapHeight = static_cast<long>(height);
+        if (cellX < 0 || cellY < 0 || cellX >= mapWidth || cellY >= mapHeight) return;
+        markCell(static_cast<size_t>(cellX), static_cast<size_t>(cellY));
+
+        const float infinity = std::numeric_limits<float>::infinity();
+        long stepX = direction.x < 0.0f ? -1 : 1;
+        long stepY = direction.y < 0.0f ? -1 : 1;
+        float deltaX = direction.x != 0.0f ? tileSize.x / std::abs(direction.x) : infinity;
+        float deltaY = direction.y != 0.0f ? tileSize.y / std::abs(direction.y) : infinity;
+        float nextX = direction.x < 0.0f ? local.x - cellX * tileSize.x : (cellX + 1) * tileSize.x - local.x;
+        float nextY = direction.y < 0.0f ? local.y - cellY * tileSize.y : (cellY + 1) * tileSize.y - local.y;
+        float sideX = direction.x != 0.0f ? nextX / std::abs(direction.x) : infinity;
+        float sideY = direction.y != 0.0f ? nextY / std::abs(direction.y) : infinity;
+
+        // the traversals reach the wall's boundary with slightly different rounding, a little slack keeps the wall cell
+        float end = distance + 1e-3f * std::min(tileSize.x, tileSize.y);
+        while (true) {
+            float crossing = std::min(sideX, sideY);
+            if (crossing > end) break;
+            if (sideX < sideY) {
+                sideX += deltaX;
+                cellX += stepX;
+            } else {
+                sideY += deltaY;
+                cellY += stepY;
+            }
+            if (cellX < 0 || cellY < 0 || cellX >= mapWidth || cellY >= mapHeight) break;
+            markCell(static_cast<size_t>(cellX), static_cast<size_t>(cellY));
+        }
+    }
+
+    bool VisibleCells::intersects(const sf::FloatRect& worldRect) const {
+        if (width == 0 || height == 0 || tileSize.x <= 0.0f || tileSize.y <= 0.0f) return false;
+        long left = static_cast<long>(std::floor((worldRect.left - position.x) / tileSize.x));
+        long top = static_cast<long>(std::floor((worldRect.top - position.y) / tileSize.y));
+        long right = static_cast<long>(std::floor((worldRect.left + worldRect.width - position.x) / tileSize.x));
+        long bottom = static_cast<long>(std::floor((worldRect.top + worldRect.height - position.y) / tileSize.y));
+        // clamped to the window, which also keeps a huge rect from walking cells nothing could have marked
+        long windowLeft = static_cast<long>(windowX), windowTop = static_cast<long>(windowY), size = static_cast<long>(windowSize);
+        left = std::max({ left, 0L, windowLeft });
+        top = std::max({ top, 0L, windowTop });
+        right = std::min({ right, static_cast<long>(width) - 1, windowLeft + size - 1 });
+        bottom = std::min({ bottom, static_cast<long>(height) - 1, windowTop + size - 1 });
+
+        for (long y = top; y <= bottom; ++y) {
+            for (long x = left; x <= right; ++x) {
+                if (stamps[stampIndex(static_cast<size_t>(x), static_cast<size_t>(y))] == generation) return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,57 @@
+//
+//  visiblecells.hpp
+//
+//
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+
+#include "../../test-assets/tiles/tiles.hpp"
+
+namespace physics {
+    /* the tiles the last frame's rays passed through, up to and including the wall each one stopped at: a potentially
+    visible set for culling sprites and anything else that only matters while the player can see it. Rays stop at
+    maxDistance, so every cell of a set lies in a square window of cells around the origin that moves with it; the stamps
+    cover just that window, addressed modulo its edge so moving it needs no copy, and memory stays the same on any map
+    size. Every stamp keeps the generation its cell was last marked in and a cell is visible when that is the current
+    generation and it is inside the current window, so starting a new set is one increment instead of a clear (the
+    stamps are only cleared when the counter wraps). The visible cells are also listed once each, in the order the rays
+    reached them */
+    class VisibleCells {
+    public:
+        void begin(const TileMap& tileMap, sf::Vector2f origin, float maxDistance); // starts an empty set for rays from origin up to maxDistance
+        void markRay(const TileMap& tileMap, sf::Vector2f origin, sf::Vector2f direction, float distance); // the cells a ray crossed up to distance
+        void markCell(size_t x, size_t y); // ignored outside the window
+
+        bool isBuiltFor(const TileMap& tileMap) const { return mapId == tileMap.getMapId() && width == tileMap.getTileMapWidth() && height == tileMap.getTileMapHeight(); }
+        bool isVisible(size_t x, size_t y) const { return inWindow(x, y) && stamps[stampIndex(x, y)] == generation; }
+        bool intersects(const sf::FloatRect& worldRect) const; // any cell the rect overlaps is visible, e.g. a sprite's bounds
+
+        const std::vector<uint32_t>& getCells() const { return cells; } // y * width + x of every visible cell
+        uint16_t getGeneration() const { return generation; } // changes with every begin
+        size_t getWidth() const { return width; }
+        size_t getHeight() const { return height; }
+        size_t getWindowSize() const { return windowSize; } // edge of the stamped window in cells
+
+    private:
+        bool inWindow(size_t x, size_t y) const { return x < width && y < height && x - windowX < windowSize && y - windowY < windowSize; }
+        size_t stampIndex(size_t x, size_t y) const { return (y % windowSize) * windowSize + x % windowSize; }
+
+        uint64_t mapId {};
+        size_t width {};
+        size_t height {};
+        sf::Vector2f position {}; // the map's, for world coordinates
+        sf::Vector2f tileSize {};
+
+        size_t windowX {}; // top left cell of the window, may lie off the map when wrapped below 0
+        size_t windowY {};
+        size_t windowSize {};
+
+        uint16_t generation {};
+        std::vector<uint16_t> stamps; // per window cell, the generation it was last marked in
+        std::vector<uint32_t> cells;
+    };
+}
@@ -0,0 +1,113 @@
+//
+//  billboards.cpp
+//
+//
+
+#include "billboards.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void BillboardRenderer::build(const std::vector<Sprite*>& candidates, const physics::RayCastFrame& frame, float tileSize, const Sprite* camera,
+                              const physics::VisibleCells* visibleCells) {
+    billboards.clear(); // all three buffers keep their capacity
+    vertices.clear();
+    batches.clear();
+    culledCount = 0;
+
+    const physics::RayTable& rayTable = frame.rayTable;
+    size_t count = std::min(frame.depth.size(), rayTable.getRayCount());
+    if (count == 0 || tileSize <= 0.0f || rayTable.getPlaneScale() <= 0.0f) return;
+
+    sf::Vector2f cameraPlane = rayTable.getCameraPlane(frame.viewDirection);
+    float planeLengthSquared = cameraPlane.x * cameraPlane.x + cameraPlane.y * cameraPlane.y;
+    const float nearDistance = 1.0f;
+
+    for (const Sprite* candidate : candidates) {
+        if (!candidate || candidate == camera || !candidate->getVisibleState()) continue;
+
+        const sf::Sprite& sprite = candidate->returnSpritesShape();
+        if (!sprite.getTexture()) continue;
+
+        sf::FloatRect bounds = sprite.getGlobalBounds();
+        if (visibleCells && !visibleCells->intersects(bounds)) {
+            ++culledCount;
+            continue;
+        }
+        sf::Vector2f relative = sf::Vector2f(bounds.left + bounds.width / 2.0f, bounds.top + bounds.height / 2.0f) - frame.origin;
+        float depth = relative.x * frame.viewDirection.x + relative.y * frame.viewDirection.y;
+        if (depth < nearDistance || depth > physics::maxRayDistance) continue;
+
+        // camera plane offset of the sprite, then the same equiangular column mapping the RayTable uses
+        float offset = (relative.x * cameraPlane.x + relative.y * cameraPlane.y) / (depth * planeLengthSquared);
+        float angle = std::atan(offset * rayTable.getPlaneScale()) / Constants::DEG_TO_RAD;
+        float column = angle / rayTable.getAngleStep() + count / 2.0f;
+
+        // one tile wide in the world is as tall on screen as a wall at that depth
+        float scale = physics::wallHeightScale / depth / tileSize;
+        billboards.push_back({ &sprite, depth, column * rayTable.getSliceWidth(), bounds.width * scale, bounds.height * scale });
+    }
+
+    std::sort(billboards.begin(), billboards.end(), [](const Billboard& a, const Billboard& b) { return a.depth > b.depth; }); // back to front
+    for (const Billboard& billboard : billboards) appendStripes(billboard, frame);
+}
+
+void BillboardRenderer::appendStripes(const Billboard& billboard, const physics::RayCastFrame& frame) {
+    const physics::RayTable& rayTable = frame.rayTable;
+    size_t count = std::min(frame.depth.size(), rayTable.getRayCount());
+    float sliceWidth = rayTable.getSliceWidth();
+    if (sliceWidth <= 0.0f) return;
+
+    float left = billboard.centerX - billboard.width / 2.0f;
+    float right = billboard.centerX + billboard.width / 2.0f;
+    if (right <= 0.0f || left >= rayTable.getViewSize().x) return;
+
+    // standing on the floor: the floor line at this depth is where a wall's bottom edge would be
+    float bottom = rayTable.getViewSize().y / 2.0f + physics::wallHeightScale / (2.0f * billboard.depth);
+    float top = bottom - billboard.height;
+
+    const sf::Texture* texture = billboard.sprite->getTexture();
+    sf::IntRect rect = billboard.sprite->getTextureRect();
+    sf::Color color = billboard.sprite->getColor();
+    size_t firstVertex = vertices.size();
+
+    long firstColumn = std::max(0L, static_cast<long>(std::floor(left / sliceWidth)));
+    long lastColumn = std::min(static_cast<long>(count) - 1, static_cast<long>(std::floor(right / sliceWidth)));
+
+    long column = firstColumn;
+    while (column <= lastColumn) {
+        // skip stripes hidden behind walls, then take the run of visible ones
+        while (column <= lastColumn && frame.depth[column] <= billboard.depth) ++column;
+        if (column > lastColumn) break;
+        long runStart = column;
+        while (column <= lastColumn && frame.depth[column] > billboard.depth) ++column;
+
+        float runLeft = std::max(left, runStart * sliceWidth);
+        float runRight = std::min(right, column * sliceWidth);
+        if (runRight <= runLeft) continue;
+
+        // the billboard faces the camera, so texture coordinates are linear in screen x
+        float u0 = rect.left + (runLeft - left) / billboard.width * rect.width;
+        float u1 = rect.left + (runRight - left) / billboard.width * rect.width;
+        float v0 = static_cast<float>(rect.top);
+        float v1 = static_cast<float>(rect.top + rect.height);
+
+        vertices.emplace_back(sf::Vector2f(runLeft, top), color, sf::Vector2f(u0, v0));
+        vertices.emplace_back(sf::Vector2f(runRight, top), color, sf::Vector2f(u1, v0));
+        vertices.emplace_back(sf::Vector2f(runRight, bottom), color, sf::Vector2f(u1, v1));
+        vertices.emplace_back(sf::Vector2f(runLeft, bottom), color, sf::Vector2f(u0, v1));
+    }
+
+    size_t added = vertices.size() - firstVertex;
+    if (added == 0) return;
+    if (!batches.empty() && batches.back().texture == texture) batches.back().vertexCount += added;
+    else batches.push_back({ texture, firstVertex, added });
+}
+
+void BillboardRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (!visibleState) return;
+    for (const Batch& batch : batches) {
+        states.texture = batch.texture;
+        target.draw(vertices.data() + batch.firstVertex, batch.vertexCount, sf::Quads, states);
+    }
+}
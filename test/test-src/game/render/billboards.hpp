@@ -0,0 +1,54 @@
+//
+//  billboards.hpp
+//
+//
+
+#pragma once
+
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "../physics/raycast.hpp"
+
+/* draws sprites standing in the 3d view as camera-facing billboards. Each candidate is projected with the frame's camera,
+sorted back to front and cut into vertical stripes per ray column; stripes behind the column's wall (frame.depth) are
+dropped and neighbouring visible stripes are merged into one quad. Sprites sharing a texture are drawn in one call */
+class BillboardRenderer : public sf::Drawable {
+public:
+    /* candidates usually come from Broadphase::queryFrustum; camera is skipped (the player doesn't see itself). with visible
+    cells, sprites whose bounds don't touch one of them are hidden behind walls and skipped before projecting */
+    void build(const std::vector<Sprite*>& candidates, const physics::RayCastFrame& frame, float tileSize, const Sprite* camera = nullptr,
+               const physics::VisibleCells* visibleCells = nullptr);
+
+    size_t getCulledCount() const { return culledCount; } // candidates the visible cells dropped in the last build
+
+    size_t getBillboardCount() const { return billboards.size(); } // sprites in front of the camera in the last build
+    size_t getQuadCount() const { return vertices.size() / 4; }
+    bool const getVisibleState() const { return visibleState; }
+    void setVisibleState(bool newVisibleState) { visibleState = newVisibleState; }
+
+private:
+    struct Billboard {
+        const sf::Sprite* sprite;
+        float depth; // distance along the view direction
+        float centerX; // screen x of the sprite's centre
+        float width; // screen size
+        float height;
+    };
+
+    // consecutive quads drawn with the same texture
+    struct Batch {
+        const sf::Texture* texture;
+        size_t firstVertex;
+        size_t vertexCount;
+    };
+
+    void appendStripes(const Billboard& billboard, const physics::RayCastFrame& frame);
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    std::vector<Billboard> billboards;
+    std::vector<sf::Vertex> vertices;
+    std::vector<Batch> batches;
+    size_t culledCount {};
+    bool visibleState = true;
+};
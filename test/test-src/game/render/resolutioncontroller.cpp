@@ -0,0 +1,57 @@
+//
+//  resolutioncontroller.cpp
+//
+//
+
+#include "resolutioncontroller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "../../test-logging/log.hpp"
+
+void ResolutionController::configure(size_t minColumns, size_t maxColumns, size_t initialColumns, float targetMs) {
+    state = State();
+    state.minColumns = std::max<size_t>(8, minColumns / 8 * 8);
+    state.maxColumns = std::max(state.minColumns, maxColumns / 8 * 8);
+    state.targetMs = targetMs;
+    state.columns = clampColumns(static_cast<float>(initialColumns), false);
+    hasAverage = false;
+
+    log_info("Dynamic resolution: " + std::to_string(state.minColumns) + " to " + std::to_string(state.maxColumns) + " columns, target " +
+             std::to_string(targetMs) + " ms, starting at " + std::to_string(state.columns));
+}
+
+void ResolutionController::addFrameTime(float frameMs) {
+    state.lastFrameMs = frameMs;
+    state.averageMs = hasAverage ? state.averageMs + smoothing * (frameMs - state.averageMs) : frameMs;
+    hasAverage = true;
+    ++state.framesSinceChange;
+    if (state.targetMs <= 0.0f || state.averageMs <= 0.0f) return;
+
+    // cost is about linear in columns, so the ratio to the target says how many columns fit
+    float fit = state.targetMs / state.averageMs;
+    if (state.averageMs > state.targetMs && state.framesSinceChange >= dropCooldown) {
+        changeColumns(clampColumns(state.columns * std::min(fit, minDropStep), false));
+    } else if (state.averageMs < state.targetMs * lowerThreshold && state.framesSinceChange >= raiseCooldown) {
+        changeColumns(clampColumns(state.columns * std::min(fit * lowerThreshold, raiseStep), true));
+    }
+}
+
+size_t ResolutionController::clampColumns(float columns, bool roundUp) const {
+    float wholePackets = roundUp ? std::ceil(columns / 8.0f) : std::floor(columns / 8.0f); // so small steps still move by a packet
+    size_t packets = static_cast<size_t>(std::max(0.0f, wholePackets));
+    return std::clamp(packets * 8, state.minColumns, state.maxColumns);
+}
+
+void ResolutionController::changeColumns(size_t newColumns) {
+    if (newColumns == state.columns) return;
+
+    // the smoothed time was measured at the old count; scale it so the next decision doesn't act on stale frames
+    state.averageMs *= static_cast<float>(newColumns) / static_cast<float>(state.columns);
+    state.lastChange = newColumns > state.columns ? 1 : -1;
+    state.columns = newColumns;
+    state.framesSinceChange = 0;
+    ++state.changes;
+}
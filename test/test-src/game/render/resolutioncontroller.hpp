@@ -0,0 +1,47 @@
+//
+//  resolutioncontroller.hpp
+//
+//
+
+#pragma once
+
+#include <cstddef>
+
+/* picks how many ray columns to cast so the cast-plus-draw time of a frame stays under a target. Frame times are
+smoothed; over the target the column count drops right away in proportion to the overshoot, under lowerThreshold of
+the target it grows by at most raiseStep, and between the two it holds. A raise has to wait raiseCooldown frames after
+any change (a drop only dropCooldown), so a count that was just too slow isn't retried straight away. Counts are whole
+packets of 8 columns within [minColumns, maxColumns]; the ray table widens each slice to keep the screen filled */
+class ResolutionController {
+public:
+    struct State {
+        size_t columns {}; // active column count
+        size_t minColumns {};
+        size_t maxColumns {};
+        float targetMs {};
+        float averageMs {}; // smoothed cast-plus-draw time
+        float lastFrameMs {};
+        int lastChange {}; // -1 lowered, 1 raised, 0 no change yet
+        size_t changes {};
+        size_t framesSinceChange {};
+    };
+
+    static constexpr float smoothing = 0.1f; // weight of the newest frame in averageMs
+    static constexpr float lowerThreshold = 0.7f; // raise only below this fraction of the target
+    static constexpr float raiseStep = 1.1f; // most a single raise multiplies the column count by
+    static constexpr float minDropStep = 0.95f; // every drop takes off at least this much
+    static constexpr size_t dropCooldown = 10; // frames
+    static constexpr size_t raiseCooldown = 60;
+
+    void configure(size_t minColumns, size_t maxColumns, size_t initialColumns, float targetMs);
+    void addFrameTime(float frameMs); // after the walls of a frame that cast every column were drawn
+    size_t getColumns() const { return state.columns; }
+    const State& getState() const { return state; }
+
+private:
+    size_t clampColumns(float columns, bool roundUp) const;
+    void changeColumns(size_t newColumns);
+
+    State state;
+    bool hasAverage = false;
+};
@@ -0,0 +1,200 @@
+//
+//  softwarerenderer.cpp
+//
+//
+
+#include "softwarerenderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void SoftwareRenderer::setTexture(std::weak_ptr<sf::Texture> newTexture) {
+    std::shared_ptr<sf::Texture> texture = newTexture.lock();
+    if (!texture) {
+        log_warning("SoftwareRenderer has no tile atlas, walls are drawn flat shaded");
+        return;
+    }
+    setAtlas(texture->copyToImage()); // GPU readback, only done once
+}
+
+void SoftwareRenderer::setAtlas(const sf::Image& image) {
+    atlasWidth = image.getSize().x;
+    atlasHeight = image.getSize().y;
+    atlas.assign(static_cast<size_t>(atlasWidth) * atlasHeight, 0);
+    if (!atlas.empty() && image.getPixelsPtr()) std::memcpy(atlas.data(), image.getPixelsPtr(), atlas.size() * sizeof(std::uint32_t)); // sf::Image is RGBA bytes too
+}
+
+void SoftwareRenderer::resize(unsigned int newWidth, unsigned int newHeight) {
+    if (newWidth == width && newHeight == height) return;
+    width = newWidth;
+    height = newHeight;
+    framebuffer.assign(static_cast<size_t>(width) * height, 0);
+
+    if (!headless) {
+        if (!frameTexture.create(width, height)) log_error("SoftwareRenderer failed to create a " + std::to_string(width) + "x" + std::to_string(height) + " texture");
+        frameSprite.setTexture(frameTexture, true);
+    }
+    log_info("SoftwareRenderer framebuffer resized to " + std::to_string(width) + "x" + std::to_string(height));
+}
+
+void SoftwareRenderer::render(const physics::RayCastFrame& frame, const TileMap& tileMap, JobSystem* jobSystem) {
+    const physics::RayTable& rayTable = frame.rayTable;
+    sf::Vector2f viewSize = rayTable.getViewSize();
+    resize(static_cast<unsigned int>(std::max(0.0f, viewSize.x)), static_cast<unsigned int>(std::max(0.0f, viewSize.y)));
+
+    size_t count = std::min(frame.columns.size(), rayTable.getRayCount());
+    if (width == 0 || height == 0) return;
+
+    pixelOffsets.resize(width);
+    for (size_t x = 0; x < width; ++x) pixelOffsets[x] = count ? rayTable.getCameraOffset(std::min(count - 1, x * count / width)) : 0.0f;
+
+    if (floorCasting) {
+        // one job per row below the horizon, each also writes its mirrored ceiling row
+        unsigned int firstRow = height / 2;
+        auto renderRows = [&](size_t begin, size_t end, size_t) {
+            for (size_t y = begin; y < end; ++y) renderFloorRow(firstRow + static_cast<unsigned int>(y), frame, tileMap);
+        };
+        size_t rows = height - firstRow;
+        if (jobSystem) jobSystem->parallelFor(rows, std::max<size_t>(8, rows / (jobSystem->getThreadCount() * 4)), renderRows);
+        else renderRows(0, rows, 0);
+    }
+
+    if (wallRendering) {
+        auto renderColumns = [&](size_t begin, size_t end, size_t) {
+            for (size_t x = begin; x < end; ++x) {
+                if (count == 0) { renderColumn(static_cast<unsigned int>(x), physics::WallColumn(), sf::IntRect()); continue; }
+
+                const physics::WallColumn& column = frame.columns[std::min(count - 1, x * count / width)];
+                sf::IntRect textureRect = column.ray.hit ? tileMap.getTileTextureRect(column.ray.tileIndex) : sf::IntRect();
+                renderColumn(static_cast<unsigned int>(x), column, textureRect);
+            }
+        };
+
+        if (jobSystem) jobSystem->parallelFor(width, std::max<size_t>(16, width / (jobSystem->getThreadCount() * 4)), renderColumns);
+        else renderColumns(0, width, 0);
+    }
+
+    upload();
+}
+
+void SoftwareRenderer::renderFloorRow(unsigned int y, const physics::RayCastFrame& frame, const TileMap& tileMap) {
+    std::uint32_t* floorRow = framebuffer.data() + static_cast<size_t>(y) * width;
+    std::uint32_t* ceilingRow = framebuffer.data() + static_cast<size_t>(height - 1 - y) * width;
+
+    // perpendicular distance where this row meets the floor; walls are wallHeightScale / distance tall and centred on the horizon
+    float rowOffset = std::max(0.5f, y + 0.5f - height / 2.0f); // odd heights put the middle row on the horizon
+    physics::WallColumn row;
+    row.ray.perpDistance = physics::wallHeightScale / (2.0f * rowOffset);
+    physics::shadeWallColumn(row); // same distance shade as a wall at that distance
+    std::uint32_t floorShade = row.shade;
+    std::uint32_t ceilingShade = row.shade * 3 / 4;
+
+    // the row's world span: start at distance along the view direction, move along the camera plane per column
+    sf::Vector2f cameraPlane = frame.rayTable.getCameraPlane(frame.viewDirection);
+    sf::Vector2f rowStart = frame.origin - tileMap.getTileMapPosition() + frame.viewDirection * row.ray.perpDistance;
+    sf::Vector2f rowSpan = cameraPlane * row.ray.perpDistance;
+
+    float tileWidth = tileMap.getTileWidth();
+    float tileHeight = tileMap.getTileHeight();
+    long mapWidth = static_cast<long>(tileMap.getTileMapWidth());
+    long mapHeight = static_cast<long>(tileMap.getTileMapHeight());
+
+    long cachedIndex = -1; // neighbouring pixels mostly land in the same tile, only look its rect up again when that changes
+    sf::IntRect textureRect;
+    bool textured = false;
+
+    constexpr unsigned int batchSize = 256;
+    float tileX[batchSize];
+    float tileY[batchSize];
+
+    for (unsigned int batch = 0; batch < width; batch += batchSize) {
+        unsigned int batchEnd = std::min(width, batch + batchSize);
+
+        // positions first, in a plain loop the compiler can vectorize
+        for (unsigned int x = batch; x < batchEnd; ++x) {
+            tileX[x - batch] = (rowStart.x + rowSpan.x * pixelOffsets[x]) / tileWidth;
+            tileY[x - batch] = (rowStart.y + rowSpan.y * pixelOffsets[x]) / tileHeight;
+        }
+
+        for (unsigned int x = batch; x < batchEnd; ++x) {
+            float positionX = tileX[x - batch];
+            float positionY = tileY[x - batch];
+            long cellX = static_cast<long>(std::floor(positionX));
+            long cellY = static_cast<long>(std::floor(positionY));
+
+            if (cellX < 0 || cellY < 0 || cellX >= mapWidth || cellY >= mapHeight) { // outside the map, let the background show
+                floorRow[x] = 0;
+                ceilingRow[x] = 0;
+                continue;
+            }
+
+            long index = cellY * mapWidth + cellX;
+            if (index != cachedIndex) {
+                cachedIndex = index;
+                textureRect = tileMap.getTileTextureRect(static_cast<size_t>(index));
+                textured = hasTexels(textureRect);
+            }
+
+            std::uint32_t color = packPixel(255, 255, 255);
+            if (textured) {
+                int texelX = textureRect.left + std::min(textureRect.width - 1, static_cast<int>((positionX - cellX) * textureRect.width));
+                int texelY = textureRect.top + std::min(textureRect.height - 1, static_cast<int>((positionY - cellY) * textureRect.height));
+                color = atlas[static_cast<size_t>(texelY) * atlasWidth + texelX];
+            }
+            floorRow[x] = shadePixel(color, floorShade);
+            ceilingRow[x] = shadePixel(color, ceilingShade);
+        }
+    }
+}
+
+bool SoftwareRenderer::hasTexels(const sf::IntRect& textureRect) const {
+    return !atlas.empty() && textureRect.width > 0 && textureRect.height > 0 && textureRect.left >= 0 && textureRect.top >= 0 &&
+           static_cast<unsigned int>(textureRect.left + textureRect.width) <= atlasWidth &&
+           static_cast<unsigned int>(textureRect.top + textureRect.height) <= atlasHeight;
+}
+
+void SoftwareRenderer::renderColumn(unsigned int x, const physics::WallColumn& column, const sf::IntRect& textureRect) {
+    std::uint32_t* pixel = framebuffer.data() + x;
+    float centerY = height / 2.0f;
+    float top = centerY - column.wallHeight / 2.0f;
+
+    // wall span clipped to the framebuffer; without floor casting everything else in the column is transparent
+    int spanTop = column.ray.hit ? std::max(0, static_cast<int>(std::ceil(top))) : 0;
+    int spanBottom = column.ray.hit ? std::min(static_cast<int>(height), static_cast<int>(std::ceil(centerY + column.wallHeight / 2.0f))) : 0;
+    spanBottom = std::max(spanTop, spanBottom);
+
+    if (!floorCasting) {
+        for (int y = 0; y < spanTop; ++y) pixel[static_cast<size_t>(y) * width] = 0;
+        for (int y = spanBottom; y < static_cast<int>(height); ++y) pixel[static_cast<size_t>(y) * width] = 0;
+    }
+    if (spanTop == spanBottom) return;
+
+    std::uint32_t shade = column.shade;
+    if (!hasTexels(textureRect)) {
+        std::uint32_t flat = packPixel(static_cast<sf::Uint8>(shade), static_cast<sf::Uint8>(shade), static_cast<sf::Uint8>(shade));
+        for (int y = spanTop; y < spanBottom; ++y) pixel[static_cast<size_t>(y) * width] = flat;
+        return;
+    }
+
+    // one texel column of the tile, stepped down the span
+    int texelX = textureRect.left + std::min(textureRect.width - 1, static_cast<int>(column.ray.wallOffset * textureRect.width));
+    const std::uint32_t* texel = atlas.data() + texelX;
+    float texelStep = textureRect.height / column.wallHeight;
+    float texelY = (spanTop - top) * texelStep;
+
+    for (int y = spanTop; y < spanBottom; ++y, texelY += texelStep) {
+        int row = textureRect.top + std::min(textureRect.height - 1, static_cast<int>(texelY));
+        pixel[static_cast<size_t>(y) * width] = shadePixel(texel[static_cast<size_t>(row) * atlasWidth], shade);
+    }
+}
+
+void SoftwareRenderer::upload() {
+    if (headless || framebuffer.empty()) return;
+    frameTexture.update(reinterpret_cast<const sf::Uint8*>(framebuffer.data())); // the whole frame in one upload
+}
+
+void SoftwareRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (headless || !visibleState || framebuffer.empty()) return;
+    target.draw(frameSprite, states);
+}
@@ -0,0 +1,75 @@
+//
+//  softwarerenderer.hpp
+//
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <SFML/Graphics.hpp>
+
+#include "../physics/raycast.hpp"
+#include "../core/jobs.hpp"
+
+/* CPU alternative to WallMesh: rasterizes the wall columns of a frame into an RGBA framebuffer (one uint32_t per pixel,
+bytes in R, G, B, A order) and uploads it as a single texture. Pixels without a wall stay transparent so the background
+shows through like it does with the quads. Headless renderers never touch the GPU; their frames are read with getPixels.
+With floor casting on, every row below the horizon and its mirrored ceiling row are filled from the tiles under them
+first; with wall rendering off only that pass runs (used under WallMesh) */
+class SoftwareRenderer : public sf::Drawable {
+public:
+    explicit SoftwareRenderer(bool headless = false) : headless(headless) {}
+
+    void setTexture(std::weak_ptr<sf::Texture> newTexture); // copies the tile atlas pixels once, walls are flat shaded without one
+    void setAtlas(const sf::Image& image); // same, from an image already in memory (headless)
+    void setFloorCasting(bool enabled) { floorCasting = enabled; }
+    void setWallRendering(bool enabled) { wallRendering = enabled; }
+
+    // renders a frame cast by calculateRayCast3d; rows (floor) and columns (walls) are split over the job system if given
+    void render(const physics::RayCastFrame& frame, const TileMap& tileMap, JobSystem* jobSystem = nullptr);
+
+    const std::vector<std::uint32_t>& getPixels() const { return framebuffer; }
+    unsigned int getWidth() const { return width; }
+    unsigned int getHeight() const { return height; }
+    bool isHeadless() const { return headless; }
+    bool const getVisibleState() const { return visibleState; }
+    void setVisibleState(bool newVisibleState) { visibleState = newVisibleState; }
+
+    static std::uint32_t packPixel(sf::Uint8 r, sf::Uint8 g, sf::Uint8 b, sf::Uint8 a = 255) {
+        return static_cast<std::uint32_t>(r) | static_cast<std::uint32_t>(g) << 8 | static_cast<std::uint32_t>(b) << 16 | static_cast<std::uint32_t>(a) << 24; // little endian
+    }
+
+    // multiplies rgb by shade / 255 and keeps alpha, like a vertex colour does for the quads
+    static std::uint32_t shadePixel(std::uint32_t color, std::uint32_t shade) {
+        std::uint32_t r = (color & 0xFF) * shade / 255;
+        std::uint32_t g = ((color >> 8) & 0xFF) * shade / 255;
+        std::uint32_t b = ((color >> 16) & 0xFF) * shade / 255;
+        return r | g << 8 | b << 16 | (color & 0xFF000000u);
+    }
+
+private:
+    void resize(unsigned int newWidth, unsigned int newHeight);
+    void renderFloorRow(unsigned int y, const physics::RayCastFrame& frame, const TileMap& tileMap);
+    void renderColumn(unsigned int x, const physics::WallColumn& column, const sf::IntRect& textureRect);
+    bool hasTexels(const sf::IntRect& textureRect) const; // rect lies inside the atlas
+    void upload();
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    std::vector<std::uint32_t> framebuffer;
+    std::vector<float> pixelOffsets; // camera plane offset of every framebuffer column (from the ray column under it)
+    unsigned int width {};
+    unsigned int height {};
+
+    std::vector<std::uint32_t> atlas;
+    unsigned int atlasWidth {};
+    unsigned int atlasHeight {};
+
+    sf::Texture frameTexture;
+    sf::Sprite frameSprite;
+    bool headless = false;
+    bool floorCasting = false;
+    bool wallRendering = true;
+    bool visibleState = true;
+};
@@ -0,0 +1,105 @@
+//
+//  wallmesh.cpp
+//
+//
+
+#include "wallmesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+bool WallMesh::SlopeRange::narrow(float dx, float delta, float tolerance) {
+    float low = std::max(min, (delta - tolerance) / dx);
+    float high = std::min(max, (delta + tolerance) / dx);
+    if (low > high) return false;
+    min = low;
+    max = high;
+    return true;
+}
+
+void WallMesh::build(const std::vector<physics::WallColumn>& columns, const physics::RayTable& rayTable, const TileMap& tileMap) {
+    vertices.clear(); // keeps capacity
+    columnCount = 0;
+
+    size_t count = std::min(columns.size(), rayTable.getRayCount());
+    sf::Vector2f viewSize = rayTable.getViewSize();
+    if (count == 0 || viewSize.x <= 0.0f) return;
+
+    // more columns than pixels: only every step-th column is used and it covers step slices
+    size_t pixelColumns = std::max<size_t>(1, static_cast<size_t>(viewSize.x));
+    size_t step = (count + pixelColumns - 1) / pixelColumns;
+    size_t maxQuads = (count + step - 1) / step;
+    if (vertices.capacity() < 4 * maxQuads) vertices.reserve(4 * maxQuads);
+
+    float sliceWidth = rayTable.getSliceWidth() * step;
+    float centerY = viewSize.y / 2.0f;
+    const float infinity = std::numeric_limits<float>::infinity();
+
+    size_t i = 0;
+    while (i < count) {
+        const physics::WallColumn& first = columns[i];
+        if (!first.ray.hit) { i += step; continue; }
+
+        sf::IntRect textureRect = tileMap.getTileTextureRect(first.ray.tileIndex);
+        float textureWidth = static_cast<float>(textureRect.width);
+        float firstTexel = first.ray.wallOffset * textureWidth;
+
+        float firstX = rayTable.getScreenX(i) + sliceWidth / 2.0f; // runs are lines through the first column's centre
+        SlopeRange heightSlope { -infinity, infinity };
+        SlopeRange texelSlope { -infinity, infinity };
+        size_t last = i;
+        size_t next = i + step;
+        ++columnCount;
+
+        for (; next < count; next += step) {
+            const physics::WallColumn& column = columns[next];
+            if (!column.ray.hit || column.ray.tileIndex != first.ray.tileIndex || column.ray.side != first.ray.side || column.shade != first.shade) break;
+
+            float dx = rayTable.getScreenX(next) + sliceWidth / 2.0f - firstX;
+            if (!heightSlope.narrow(dx, column.wallHeight - first.wallHeight, heightTolerance)) break;
+            if (!texelSlope.narrow(dx, column.ray.wallOffset * textureWidth - firstTexel, texelTolerance)) break;
+
+            last = next;
+            ++columnCount;
+        }
+
+        // aim at the last column if that stays inside every column's tolerance
+        float heightPerPixel = 0.0f;
+        float texelPerPixel = 0.0f;
+        if (last != i) {
+            float dx = rayTable.getScreenX(last) + sliceWidth / 2.0f - firstX;
+            heightPerPixel = std::clamp((columns[last].wallHeight - first.wallHeight) / dx, heightSlope.min, heightSlope.max);
+            texelPerPixel = std::clamp((columns[last].ray.wallOffset * textureWidth - firstTexel) / dx, texelSlope.min, texelSlope.max);
+        }
+
+        float left = rayTable.getScreenX(i);
+        float right = std::min(rayTable.getScreenX(last) + sliceWidth, viewSize.x);
+        float leftHeight = std::max(0.0f, first.wallHeight + heightPerPixel * (left - firstX));
+        float rightHeight = std::max(0.0f, first.wallHeight + heightPerPixel * (right - firstX));
+        float leftTexel = std::clamp(firstTexel + texelPerPixel * (left - firstX), 0.0f, textureWidth);
+        float rightTexel = std::clamp(firstTexel + texelPerPixel * (right - firstX), 0.0f, textureWidth);
+        appendQuad(left, right, leftHeight, rightHeight, leftTexel, rightTexel, centerY, textureRect, first.shade);
+        i = next;
+    }
+}
+
+void WallMesh::appendQuad(float left, float right, float leftHeight, float rightHeight, float leftTexel, float rightTexel,
+                          float centerY, sf::IntRect textureRect, sf::Uint8 shade) {
+    sf::Color wallColor(shade, shade, shade); // multiplies the texture, darker with distance
+    float textureLeft = static_cast<float>(textureRect.left);
+    float textureTop = static_cast<float>(textureRect.top);
+    float textureBottom = static_cast<float>(textureRect.top + textureRect.height);
+
+    vertices.emplace_back(sf::Vector2f(left, centerY - leftHeight / 2.0f), wallColor, sf::Vector2f(textureLeft + leftTexel, textureTop));        // Top Left
+    vertices.emplace_back(sf::Vector2f(right, centerY - rightHeight / 2.0f), wallColor, sf::Vector2f(textureLeft + rightTexel, textureTop));     // Top Right
+    vertices.emplace_back(sf::Vector2f(right, centerY + rightHeight / 2.0f), wallColor, sf::Vector2f(textureLeft + rightTexel, textureBottom)); // Bottom Right
+    vertices.emplace_back(sf::Vector2f(left, centerY + leftHeight / 2.0f), wallColor, sf::Vector2f(textureLeft + leftTexel, textureBottom));    // Bottom Left
+}
+
+void WallMesh::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (!visibleState || vertices.empty()) return;
+    std::shared_ptr<sf::Texture> atlas = texture.lock();
+    if (atlas) states.texture = atlas.get(); // one texture for every wall, so one draw call
+    target.draw(vertices.data(), vertices.size(), sf::Quads, states);
+}
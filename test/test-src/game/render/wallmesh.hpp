@@ -0,0 +1,49 @@
+//
+//  wallmesh.hpp
+//
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <SFML/Graphics.hpp>
+
+#include "../physics/raycast.hpp"
+
+/* builds the 3d wall quads from a frame of ray columns. Neighbouring columns that hit the same face of the same tile with
+the same shade become one quad as long as their heights (within heightTolerance pixels) and texture columns (within
+texelTolerance texels) stay on a straight line. Every quad is textured with its tile's rect from the tile atlas so the
+whole wall pass is one draw call. The vertex buffer keeps its capacity between frames and never holds more quads than
+the view is pixels wide */
+class WallMesh : public sf::Drawable {
+public:
+    explicit WallMesh(float heightTolerance = 0.5f, float texelTolerance = 0.5f) : heightTolerance(heightTolerance), texelTolerance(texelTolerance) {}
+
+    void setTexture(std::weak_ptr<sf::Texture> newTexture) { texture = newTexture; } // tile atlas, walls are drawn flat shaded without one
+    void build(const std::vector<physics::WallColumn>& columns, const physics::RayTable& rayTable, const TileMap& tileMap);
+
+    size_t getQuadCount() const { return vertices.size() / 4; }
+    size_t getColumnCount() const { return columnCount; } // columns that hit a wall in the last build
+    bool const getVisibleState() const { return visibleState; }
+    void setVisibleState(bool newVisibleState) { visibleState = newVisibleState; }
+
+private:
+    // line through a run's first column that every later column has to stay within tolerance of
+    struct SlopeRange {
+        float min;
+        float max;
+        bool narrow(float dx, float delta, float tolerance); // false if the column doesn't fit
+    };
+
+    void appendQuad(float left, float right, float leftHeight, float rightHeight, float leftTexel, float rightTexel,
+                    float centerY, sf::IntRect textureRect, sf::Uint8 shade);
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    std::vector<sf::Vertex> vertices;
+    std::weak_ptr<sf::Texture> texture;
+    float heightTolerance {};
+    float texelTolerance {};
+    size_t columnCount {};
+    bool visibleState = true;
+};
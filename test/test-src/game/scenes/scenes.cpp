@@ -7,7 +7,9 @@
 //////////////////////////////////////////////////////////////////////////////////////////////
 
 // Scene constructure sets up window and sprite respawn times 
-Scene::Scene( sf::RenderWindow& gameWindow ) : window(gameWindow), quadtree(0.0f, 0.0f, Constants::WORLD_WIDTH, Constants::WORLD_HEIGHT){ 
+Scene::Scene( sf::RenderWindow& gameWindow, JobSystem& jobSystem ) : window(gameWindow), jobSystem(jobSystem), broadphase(physics::makeBroadphase(physics::parseBroadphaseKind(Constants::BROADPHASE), sf::FloatRect(0.0f, 0.0f, Constants::WORLD_WIDTH, Constants::WORLD_HEIGHT),
+                                                                                                     Constants::TILEMAP_POSITION, sf::Vector2f(Constants::TILE_WIDTH, Constants::TILE_HEIGHT))),
+                                                                                                     rayTraversal(physics::parseRayTraversal(Constants::RAY_TRAVERSAL)){ 
     MetaComponents::smallView = sf::View(Constants::VIEW_RECT); 
     MetaComponents::smallView.setViewport(sf::FloatRect(0.75f, 0.f, 0.25f, 0.25f));
 
@@ -95,8 +97,18 @@ void gamePlayScene::createAssets() {
         }
        
         tileMap1 = std::make_unique<TileMap>(tiles1.data(), Constants::TILES_NUMBER, Constants::TILEMAP_WIDTH, Constants::TILEMAP_HEIGHT, Constants::TILE_WIDTH, Constants::TILE_HEIGHT, Constants::TILEMAP_FILEPATH, Constants::TILEMAP_POSITION); 
+        if (Constants::TILEMAP_STREAMING && tileMap1->enableStreaming(Constants::TILEMAP_STREAMING_BUDGET_MB * 1024 * 1024, Constants::TILEMAP_STREAMING_PIN_RADIUS)) {
+            tileMap1->prefetch(player->getSpritePos()); // the player's surroundings are there before the first frame
+        }
+        if (Constants::DYNAMIC_RESOLUTION) resolution.configure(Constants::RAYS_MIN / 2, Constants::RAYS_MAX / 2, Constants::RAYS_NUM / 2, Constants::FRAME_TIME_TARGET_MS);
+        log_info("Ray casting with the " + physics::rayKernelName(physics::detectRayKernel()) + " kernel, " + physics::rayTraversalName(rayTraversal) + " traversal");
+        if (rayTraversal == physics::RayTraversal::DISTANCE) physics::cachedDistanceField.sync(*tileMap1, &jobSystem); // built on every thread now instead of in the first frame
         rays = sf::VertexArray(sf::Lines, Constants::RAYS_NUM);
         rays = sf::VertexArray(sf::Quads, Constants::RAYS_NUM);
+        wallMesh.setTexture(Constants::TILES_TEXTURE); // walls sample the same atlas as the tile map
+        softwareRenderer.setFloorCasting(Constants::FLOOR_CASTING);
+        softwareRenderer.setWallRendering(Constants::SOFTWARE_RENDERER); // otherwise wallMesh draws the walls on top of it
+        if (Constants::SOFTWARE_RENDERER || Constants::FLOOR_CASTING) softwareRenderer.setTexture(Constants::TILES_TEXTURE);
    
         // Music
         backgroundMusic = std::make_unique<MusicClass>(std::move(Constants::BACKGROUNDMUSIC_MUSIC), Constants::BACKGROUNDMUSIC_VOLUME);
@@ -122,8 +134,10 @@ void gamePlayScene::setInitialTimes(){
 }
 
 void gamePlayScene::insertItemsInQuadtree(){
-    quadtree.insert(player);  
-    quadtree.insert(bullets[bullets.size() - 1]); 
+    broadphase->insert(player);  
+    broadphase->insert(bullets[bullets.size() - 1]); 
+    broadphase->update(); // queryable from the first frame
+    handleOverlaps(); // takes this update's begin events, later updates only report what changed since
 }
 
 void gamePlayScene::respawnAssets(){
@@ -161,10 +175,14 @@ void gamePlayScene::handleSpaceKey() {
 void gamePlayScene::handleMovementKeys() {
     if (!player->getMoveState()) return;
 
-    int tileX = static_cast<int>((player->getSpritePos().x - Constants::TILEMAP_POSITION.x) / Constants::TILE_WIDTH);
-    int tileY = static_cast<int>((player->getSpritePos().y - Constants::TILEMAP_POSITION.y) / Constants::TILE_HEIGHT);
-    int tileIndexInMap = tileY * Constants::TILEMAP_WIDTH + tileX;
-    bool canWalkOnTile = tileMap1->getTile(tileIndexInMap)->getWalkable(); 
+    // reads the map's own size and the chunks' walkable bits; off the map counts as a wall
+    auto walkableAt = [this](sf::Vector2f position) {
+        float tileX = std::floor((position.x - tileMap1->getTileMapPosition().x) / tileMap1->getTileWidth());
+        float tileY = std::floor((position.y - tileMap1->getTileMapPosition().y) / tileMap1->getTileHeight());
+        if (tileX < 0.0f || tileY < 0.0f || tileX >= tileMap1->getTileMapWidth() || tileY >= tileMap1->getTileMapHeight()) return false;
+        return tileMap1->isWalkable(static_cast<size_t>(tileX), static_cast<size_t>(tileY));
+    };
+    bool canWalkOnTile = walkableAt(player->getSpritePos());
 
     sf::FloatRect playerBounds = player->returnSpritesShape().getGlobalBounds();
     sf::Vector2f originalPlayerPos = player->getSpritePos();
@@ -186,10 +204,7 @@ void gamePlayScene::handleMovementKeys() {
         physics::spriteMover(player, physics::followDirVecOpposite); 
     }   
 
-    int newTileX = static_cast<int>((player->getSpritePos().x - Constants::TILEMAP_POSITION.x) / Constants::TILE_WIDTH);
-    int newTileY = static_cast<int>((player->getSpritePos().y - Constants::TILEMAP_POSITION.y) / Constants::TILE_HEIGHT);
-    int newTileIndexInMap = newTileY * Constants::TILEMAP_WIDTH + newTileX;
-    bool canWalkOnTileAgain = tileMap1->getTile(newTileIndexInMap)->getWalkable(); 
+    bool canWalkOnTileAgain = walkableAt(player->getSpritePos());
 
     if(!canWalkOnTileAgain){
         player->changePosition(originalPlayerPos);
@@ -210,7 +225,22 @@ void gamePlayScene::handleMovementKeys() {
 void gamePlayScene::handleGameEvents() { 
     scoreText->getText().setString("Score: " + std::to_string(score));
 
-    physics::calculateRayCast3d(player, tileMap1, rays, wallLine); 
+    if (tileMap1) tileMap1->updateStreaming(player->getSpritePos(), player->getDirectionVector(), physics::maxRayDistance); // no-op unless streaming
+    auto castStart = std::chrono::steady_clock::now();
+    physics::calculateRayCast3d(player, tileMap1, rays, rayTraversal, &jobSystem, Constants::DYNAMIC_RESOLUTION ? resolution.getColumns() : 0); 
+    if (tileMap1) {
+        const physics::RayCastFrame& frame = physics::cachedRayCastFrame;
+        if (frame.changed) { // an idle camera over an unchanged map keeps last frame's walls and floor
+            if (Constants::SOFTWARE_RENDERER || Constants::FLOOR_CASTING) softwareRenderer.render(frame, *tileMap1, &jobSystem);
+            if (!Constants::SOFTWARE_RENDERER) wallMesh.build(frame.columns, frame.rayTable, *tileMap1);
+        }
+
+        physics::ViewFrustum frustum = physics::makeViewFrustum(frame, physics::maxRayDistance);
+        billboardCandidates.clear();
+        broadphase->queryFrustum(frustum, billboardCandidates);
+        billboards.build(billboardCandidates, frame, Constants::TILE_WIDTH, player.get(), Constants::VISIBLE_CELLS ? &frame.visibleCells : nullptr);
+    }
+    castMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - castStart).count();
   
 } 
 
@@ -226,7 +256,8 @@ void gamePlayScene::update() {
         handleInvisibleSprites();
 
         updatePlayerAndView(); 
-        quadtree.update(); 
+        broadphase->update(); 
+        handleOverlaps();
 
         // Set the view for the window
         window.setView(MetaComponents::smallView);
@@ -244,6 +275,35 @@ void gamePlayScene::changeAnimation(){
    for (const auto& bullet : bullets) if (bullet) bullet->changeAnimation();
 }
 
+void gamePlayScene::handleOverlaps() {
+    // sprites whose bounds overlap the player's: a broadphase with overlap events opens them on begin and closes them on end,
+    // the others are asked around the player every update. only those get the pixel test
+    Sprite* playerSprite = player.get();
+    if (const std::vector<physics::OverlapEvent>* events = broadphase->getOverlapEvents()) {
+        for (const physics::OverlapEvent& event : *events) {
+            if (event.phase == physics::OverlapPhase::PERSIST || (event.first != playerSprite && event.second != playerSprite)) continue;
+            Sprite* other = event.first == playerSprite ? event.second : event.first;
+            auto open = std::find(openContacts.begin(), openContacts.end(), other);
+            if (event.phase == physics::OverlapPhase::BEGIN && open == openContacts.end()) openContacts.push_back(other);
+            else if (event.phase == physics::OverlapPhase::END && open != openContacts.end()) openContacts.erase(open);
+        }
+    } else {
+        openContacts.clear();
+        broadphase->query(player->returnSpritesShape().getGlobalBounds(), openContacts);
+        openContacts.erase(std::remove(openContacts.begin(), openContacts.end(), playerSprite), openContacts.end());
+    }
+
+    playerContacts.clear();
+    if (openContacts.empty()) return;
+    physics::CollisionData playerData = physics::extractCollisionData(playerSprite);
+    for (Sprite* other : openContacts) {
+        physics::CollisionData otherData = physics::extractCollisionData(other);
+        if (physics::pixelPerfectCollision(playerData.bitmask, playerData.position, playerData.size, otherData.bitmask, otherData.position, otherData.size)) {
+            playerContacts.push_back(other);
+        }
+    }
+}
+
 void gamePlayScene::updatePlayerAndView() {
 
 }
@@ -277,7 +337,14 @@ void gamePlayScene::drawInBigView(){
 
     drawVisibleObject(backgroundBig);
 
-    window.draw(wallLine);
+    auto drawStart = std::chrono::steady_clock::now();
+    if (Constants::SOFTWARE_RENDERER || Constants::FLOOR_CASTING) window.draw(softwareRenderer);
+    if (!Constants::SOFTWARE_RENDERER) window.draw(wallMesh);
+    window.draw(billboards); // after the walls, hidden stripes are already clipped against the depth buffer
+    // frames served from the ray cache cast few or no columns and would read as headroom the next full cast doesn't have
+    const physics::RayCastFrame& castFrame = physics::cachedRayCastFrame;
+    bool fullCast = castFrame.castCount > 0 && castFrame.castCount == castFrame.columns.size();
+    if (Constants::DYNAMIC_RESOLUTION && fullCast) resolution.addFrameTime(castMs + std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - drawStart).count());
 
     drawVisibleObject(bullets[0]); 
     drawVisibleObject(frame); 
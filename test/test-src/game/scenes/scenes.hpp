@@ -12,6 +12,7 @@
 #include <vector>
 #include <memory>
 #include <array>
+#include <chrono>
 
 #include "../test-assets/sound/sound.hpp"      
 #include "../test-assets/fonts/fonts.hpp"      
@@ -19,11 +20,16 @@
 #include "../physics/physics.hpp"             
 #include "../utils/utils.hpp"             
 #include "../camera/window.hpp"                 
+#include "../core/jobs.hpp"
+#include "../render/wallmesh.hpp"
+#include "../render/softwarerenderer.hpp"
+#include "../render/billboards.hpp"
+#include "../render/resolutioncontroller.hpp"
 
 // Base scene class 
 class Scene {
  public:
-  Scene( sf::RenderWindow& gameWindow );
+  Scene( sf::RenderWindow& gameWindow, JobSystem& jobSystem );
   virtual ~Scene() = default; 
 
   // base functions inside scene
@@ -32,6 +38,7 @@ class Scene {
 
  protected:
   sf::RenderWindow& window; // from game.hpp
+  JobSystem& jobSystem; // from game.hpp, shared by every scene
   FlagSystem::SceneEvents sceneEvents; // scene's own flag events
 
   // blank templates here
@@ -56,7 +63,8 @@ class Scene {
   void restartScene();
   void handleGameFlags(); 
 
-  physics::Quadtree quadtree; 
+  std::unique_ptr<physics::Broadphase> broadphase; // Constants::BROADPHASE picks the kind
+  physics::RayTraversal rayTraversal; // Constants::RAY_TRAVERSAL, parsed once so a typo warns once
 };
 
 // in use (the main scene in test game)
@@ -89,6 +97,7 @@ class gamePlayScene : public virtual Scene{
   void updatePlayerAndView(); 
   void updateEntityStates(); 
   void changeAnimation();
+  void handleOverlaps(); // pixel tests of the sprites whose bounds overlap the player's, keeps playerContacts
 
   void draw() override; 
   void drawInBigView();
@@ -109,7 +118,14 @@ class gamePlayScene : public virtual Scene{
 
   // for 3d walls
   sf::VertexArray rays;
-  sf::VertexArray wallLine; 
+  WallMesh wallMesh; 
+  SoftwareRenderer softwareRenderer; // walls instead of wallMesh when Constants::SOFTWARE_RENDERER is set, floor and ceiling with Constants::FLOOR_CASTING
+  BillboardRenderer billboards; // sprites seen in the 3d view
+  std::vector<Sprite*> billboardCandidates; // broadphase query output, reused every frame
+  ResolutionController resolution; // ray count under Constants::DYNAMIC_RESOLUTION
+  float castMs {}; // this frame's cast and mesh build, the draw time is added in drawInBigView
+  std::vector<Sprite*> openContacts; // sprites whose bounds overlap the player's, as of the last broadphase update
+  std::vector<Sprite*> playerContacts; // the ones of them touching the player pixel for pixel
 
   std::unique_ptr<MusicClass> backgroundMusic;
 
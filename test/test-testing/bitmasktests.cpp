@@ -0,0 +1,108 @@
+//
+//  bitmasktests.cpp
+//
+//
+
+#include "unittest.hpp"
+#include "../test-src/game/physics/physics.hpp"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // a bitmask made through the game's layout next to one byte per pixel for the reference test
+    struct TestMask {
+        std::shared_ptr<sf::Uint8[]> bitmask;
+        std::vector<uint8_t> pixels;
+        unsigned int width;
+        unsigned int height;
+    };
+
+    TestMask makeTestMask(std::mt19937& random, unsigned int width, unsigned int height, unsigned int density) {
+        TestMask mask { Constants::makeBitmask(width, height), std::vector<uint8_t>(width * height, 0), width, height };
+        uint64_t* words = reinterpret_cast<uint64_t*>(mask.bitmask.get());
+        for (unsigned int y = 0; y < height; ++y) {
+            for (unsigned int x = 0; x < width; ++x) {
+                if (random() % 1000 >= density) continue;
+                mask.pixels[y * width + x] = 1;
+                words[y * Constants::bitmaskRowWords(width) + x / 64] |= uint64_t(1) << (x % 64);
+            }
+        }
+        return mask;
+    }
+
+    // the per pixel test the row words replaced
+    bool referenceCollision(const TestMask& a, sf::Vector2f positionA, const TestMask& b, sf::Vector2f positionB) {
+        int ax = static_cast<int>(positionA.x), ay = static_cast<int>(positionA.y), bx = static_cast<int>(positionB.x), by = static_cast<int>(positionB.y);
+        for (int y = std::max(ay, by); y < std::min(ay + static_cast<int>(a.height), by + static_cast<int>(b.height)); ++y) {
+            for (int x = std::max(ax, bx); x < std::min(ax + static_cast<int>(a.width), bx + static_cast<int>(b.width)); ++x) {
+                if (a.pixels[(y - ay) * a.width + x - ax] && b.pixels[(y - by) * b.width + x - bx]) return true;
+            }
+        }
+        return false;
+    }
+}
+
+TEST_CASE("bitmask rows have a zero guard word and are 32 byte aligned", "[bitmask]") {
+    for (unsigned int width : { 1u, 63u, 64u, 65u, 128u, 255u, 256u, 700u }) {
+        INFO("width " << width);
+        CHECK(Constants::bitmaskRowWords(width) * 64 >= width + 64); // a 64 pixel read from the last pixel stays in the row
+
+        std::shared_ptr<sf::Uint8[]> bitmask = Constants::makeBitmask(width, 7);
+        CHECK(reinterpret_cast<uintptr_t>(bitmask.get()) % 32 == 0);
+        const uint64_t* words = reinterpret_cast<const uint64_t*>(bitmask.get());
+        size_t clearWords = 0;
+        for (size_t i = 0; i < Constants::bitmaskRowWords(width) * 7; ++i) clearWords += words[i] == 0;
+        CHECK(clearWords == Constants::bitmaskRowWords(width) * 7);
+    }
+
+    // every pixel lands on its own bit, lowest bit leftmost
+    std::mt19937 random(25);
+    TestMask mask = makeTestMask(random, 130, 5, 500);
+    size_t wrongPixels = 0;
+    for (unsigned int y = 0; y < mask.height; ++y) {
+        for (unsigned int x = 0; x < mask.width; ++x) wrongPixels += Constants::bitmaskPixel(mask.bitmask, mask.width, x, y) != (mask.pixels[y * mask.width + x] != 0);
+    }
+    CHECK(wrongPixels == 0);
+}
+
+// random masks at random offsets through the 64-bit word loop and, where the CPU has it, the AVX2 path (overlaps of 256 pixels and up)
+TEST_CASE("pixelPerfectCollision matches a per pixel test", "[bitmask]") {
+    std::vector<physics::RayKernel> kernels { physics::RayKernel::SCALAR };
+    if (physics::detectRayKernel() == physics::RayKernel::AVX2) kernels.push_back(physics::RayKernel::AVX2);
+
+    for (physics::RayKernel kernel : kernels) {
+        SECTION(physics::rayKernelName(kernel)) {
+            std::mt19937 random(25);
+            const unsigned int widths[] = { 1, 20, 32, 63, 64, 65, 100, 256, 300, 700 };
+            size_t tests = 0, hits = 0, mismatches = 0;
+            std::string firstMismatch;
+
+            for (size_t i = 0; i < 5000; ++i) {
+                // mostly sparse masks, so a hit often hinges on a single pixel
+                unsigned int density = random() % 3 == 0 ? 2 : random() % 300;
+                TestMask a = makeTestMask(random, widths[random() % 10], 1 + random() % 40, density);
+                TestMask b = makeTestMask(random, widths[random() % 10], 1 + random() % 40, density);
+                sf::Vector2f positionA(static_cast<float>(random() % 400), static_cast<float>(random() % 60));
+                sf::Vector2f positionB(static_cast<float>(random() % 400), static_cast<float>(random() % 60));
+
+                bool expected = referenceCollision(a, positionA, b, positionB);
+                bool result = physics::pixelPerfectCollision(a.bitmask, positionA, sf::Vector2f(static_cast<float>(a.width), static_cast<float>(a.height)),
+                                                             b.bitmask, positionB, sf::Vector2f(static_cast<float>(b.width), static_cast<float>(b.height)), kernel);
+                ++tests;
+                hits += expected;
+                if (result != expected && !mismatches++) {
+                    firstMismatch = std::to_string(a.width) + "x" + std::to_string(a.height) + " at (" + std::to_string(positionA.x) + ", " + std::to_string(positionA.y) + ") vs " +
+                                    std::to_string(b.width) + "x" + std::to_string(b.height) + " at (" + std::to_string(positionB.x) + ", " + std::to_string(positionB.y) + ")";
+                }
+            }
+
+            INFO(firstMismatch);
+            CHECK(mismatches == 0);
+            CHECK(hits > tests / 20); // both outcomes are covered
+            CHECK(hits < tests - tests / 20);
+        }
+    }
+}
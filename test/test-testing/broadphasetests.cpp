@@ -0,0 +1,182 @@
+//
+//  broadphasetests.cpp
+//
+//
+
+#include "unittest.hpp"
+#include "../test-src/game/physics/broadphase.hpp"
+#include "../test-src/game/physics/sweepandprune.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    using SpritePair = std::pair<Sprite*, Sprite*>;
+
+    SpritePair ordered(Sprite* a, Sprite* b) { return std::minmax(a, b); }
+
+    // sprites of 8 to 48 pixels scattered over a world of worldSize, most of them registered
+    struct Scene {
+        static constexpr float worldSize = 1500.0f;
+        std::vector<std::unique_ptr<Static>> sprites;
+        std::vector<bool> registered;
+
+        Scene(size_t count, std::mt19937& random) {
+            for (size_t i = 0; i < count; ++i) {
+                sprites.push_back(std::make_unique<Static>(sf::Vector2f(), sf::Vector2f(1.0f, 1.0f), std::weak_ptr<sf::Texture>()));
+                sprites.back()->returnSpritesShape().setTextureRect(sf::IntRect(0, 0, 8 + random() % 40, 8 + random() % 40));
+                sprites.back()->returnSpritesShape().setPosition(static_cast<float>(random() % 1500), static_cast<float>(random() % 1500));
+            }
+            registered.assign(count, false);
+        }
+
+        sf::FloatRect bounds(size_t i) const { return sprites[i]->returnSpritesShape().getGlobalBounds(); }
+
+        // coherent motion of a couple of pixels, with the odd sprite jumping anywhere; some sprites move in or out of the index
+        void step(physics::Broadphase& broadphase, std::mt19937& random) {
+            for (auto& sprite : sprites) {
+                sf::Vector2f position = sprite->returnSpritesShape().getPosition();
+                if (random() % 500 == 0) position = sf::Vector2f(static_cast<float>(random() % 1500), static_cast<float>(random() % 1500));
+                else position += sf::Vector2f(static_cast<float>(static_cast<int>(random() % 5) - 2), static_cast<float>(static_cast<int>(random() % 5) - 2));
+                sprite->returnSpritesShape().setPosition(position);
+            }
+            std::set<size_t> toggled;
+            for (size_t k = 0; k < 5; ++k) {
+                size_t i = random() % sprites.size();
+                if (!toggled.insert(i).second) continue;
+                if (registered[i]) broadphase.remove(sprites[i].get());
+                else broadphase.insert(sprites[i].get());
+                registered[i] = !registered[i];
+            }
+        }
+
+        std::set<SpritePair> overlappingPairs() const {
+            std::set<SpritePair> pairs;
+            for (size_t i = 0; i < sprites.size(); ++i) {
+                if (!registered[i]) continue;
+                for (size_t j = i + 1; j < sprites.size(); ++j) {
+                    if (registered[j] && bounds(i).intersects(bounds(j))) pairs.insert(ordered(sprites[i].get(), sprites[j].get()));
+                }
+            }
+            return pairs;
+        }
+
+        template<typename Test>
+        std::vector<Sprite*> matching(const Test& test) const {
+            std::vector<Sprite*> result;
+            for (size_t i = 0; i < sprites.size(); ++i) {
+                if (registered[i] && test(bounds(i))) result.push_back(sprites[i].get());
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+    };
+}
+
+// every broadphase against brute force over frames of moving, inserted and removed sprites
+TEST_CASE("broadphases find the same pairs and sprites as brute force", "[broadphase]") {
+    testing::loadConfig();
+    for (physics::BroadphaseKind kind : { physics::BroadphaseKind::QUADTREE, physics::BroadphaseKind::LOOSE_QUADTREE,
+                                          physics::BroadphaseKind::SPATIAL_HASH, physics::BroadphaseKind::SWEEP_AND_PRUNE }) {
+        SECTION(physics::broadphaseKindName(kind)) {
+            std::mt19937 random(23);
+            Scene scene(600, random);
+            std::unique_ptr<physics::Broadphase> broadphase = physics::makeBroadphase(kind, sf::FloatRect(0.0f, 0.0f, Scene::worldSize, Scene::worldSize),
+                                                                                      sf::Vector2f(), sf::Vector2f(32.0f, 32.0f));
+            for (size_t i = 0; i < scene.sprites.size(); ++i) {
+                if (random() % 10 == 0) continue;
+                broadphase->insert(scene.sprites[i].get());
+                scene.registered[i] = true;
+            }
+
+            size_t badPairFrames = 0, badPrechecks = 0, badQueries = 0, badFrustums = 0;
+            for (size_t frame = 0; frame < 60; ++frame) {
+                scene.step(*broadphase, random);
+                broadphase->update();
+
+                std::vector<SpritePair> found;
+                broadphase->findPairs(found);
+                std::set<SpritePair> pairs;
+                for (const SpritePair& pair : found) pairs.insert(ordered(pair.first, pair.second));
+                std::set<SpritePair> expected = scene.overlappingPairs();
+                if (pairs != expected || pairs.size() != found.size()) ++badPairFrames;
+
+                // the narrow phase pre-check agrees with the pairs, for overlapping and random sprites alike
+                for (const SpritePair& pair : expected) badPrechecks += !broadphase->mayOverlap(*pair.first, *pair.second);
+                for (size_t k = 0; k < 50; ++k) {
+                    size_t i = random() % scene.sprites.size(), j = random() % scene.sprites.size();
+                    if (i == j || !scene.registered[i] || !scene.registered[j]) continue;
+                    Sprite* a = scene.sprites[i].get();
+                    Sprite* b = scene.sprites[j].get();
+                    badPrechecks += broadphase->mayOverlap(*a, *b) != (expected.count(ordered(a, b)) > 0);
+                }
+
+                for (size_t q = 0; q < 10; ++q) {
+                    // partly outside the world too
+                    sf::FloatRect area(static_cast<float>(random() % 1700) - 100.0f, static_cast<float>(random() % 1700) - 100.0f,
+                                       static_cast<float>(random() % 400), static_cast<float>(random() % 400));
+                    std::vector<Sprite*> result;
+                    broadphase->query(area, result);
+                    std::sort(result.begin(), result.end());
+                    if (result != scene.matching([&area](const sf::FloatRect& bounds) { return area.intersects(bounds); })) ++badQueries;
+
+                    physics::ViewFrustum frustum;
+                    frustum.origin = sf::Vector2f(static_cast<float>(random() % 1500), static_cast<float>(random() % 1500));
+                    frustum.farLeft = frustum.origin + sf::Vector2f(static_cast<float>(random() % 1000) - 500.0f, static_cast<float>(random() % 1000) - 500.0f);
+                    frustum.farRight = frustum.origin + sf::Vector2f(static_cast<float>(random() % 1000) - 500.0f, static_cast<float>(random() % 1000) - 500.0f);
+                    result.clear();
+                    broadphase->queryFrustum(frustum, result);
+                    std::sort(result.begin(), result.end());
+                    if (result != scene.matching([&frustum](const sf::FloatRect& bounds) { return frustum.intersects(bounds); })) ++badFrustums;
+                }
+            }
+
+            CHECK(badPairFrames == 0);
+            CHECK(badPrechecks == 0);
+            CHECK(badQueries == 0);
+            CHECK(badFrustums == 0);
+            CHECK((broadphase->getOverlapEvents() != nullptr) == (kind == physics::BroadphaseKind::SWEEP_AND_PRUNE)); // the others are queried instead
+        }
+    }
+}
+
+// begin / persist / end events of 200 frames against the brute force pairs of consecutive frames
+TEST_CASE("sweep and prune events follow the overlapping pairs", "[broadphase][sweepandprune]") {
+    std::mt19937 random(24);
+    Scene scene(2000, random);
+    physics::SweepAndPrune sweepAndPrune;
+    for (size_t i = 0; i < scene.sprites.size(); ++i) {
+        sweepAndPrune.insert(scene.sprites[i].get());
+        scene.registered[i] = true;
+    }
+
+    std::set<SpritePair> previous;
+    size_t badFrames = 0, firstBadFrame = 0;
+    for (size_t frame = 0; frame < 200; ++frame) {
+        scene.step(sweepAndPrune, random);
+        sweepAndPrune.update();
+        std::set<SpritePair> current = scene.overlappingPairs();
+
+        std::set<SpritePair> begins, persists, ends;
+        for (const physics::OverlapEvent& event : *sweepAndPrune.getOverlapEvents()) {
+            SpritePair pair = ordered(event.first, event.second);
+            (event.phase == physics::OverlapPhase::BEGIN ? begins : event.phase == physics::OverlapPhase::PERSIST ? persists : ends).insert(pair);
+        }
+        std::set<SpritePair> expectedBegins, expectedPersists, expectedEnds;
+        for (const SpritePair& pair : current) (previous.count(pair) ? expectedPersists : expectedBegins).insert(pair);
+        for (const SpritePair& pair : previous) if (!current.count(pair)) expectedEnds.insert(pair);
+
+        bool good = begins == expectedBegins && persists == expectedPersists && ends == expectedEnds &&
+                    sweepAndPrune.getOverlapEvents()->size() == begins.size() + persists.size() + ends.size();
+        if (!good && !badFrames++) firstBadFrame = frame;
+        previous.swap(current);
+    }
+
+    INFO("first bad frame " << firstBadFrame);
+    CHECK(badFrames == 0);
+    CHECK(!previous.empty()); // the scene is dense enough to have pairs at all
+}
@@ -0,0 +1,135 @@
+//
+//  mipgridtests.cpp
+//
+//
+
+#include "unittest.hpp"
+#include "../test-src/game/physics/raycast.hpp"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    bool sameHit(const physics::RayHit& hit, const physics::RayHit& expected) {
+        return hit.hit == expected.hit && hit.tileX == expected.tileX && hit.tileY == expected.tileY && hit.side == expected.side &&
+               std::abs(hit.distance - expected.distance) <= 1e-2f && std::abs(hit.wallOffset - expected.wallOffset) <= 1e-3f;
+    }
+
+    /* every ray of a full circle from count random walkable points, through the mip grid and through a distance field synced
+    to the map; returns the rays that didn't end in the same cell the same way as castRay */
+    size_t compareWithCastRay(const TileMap& tileMap, size_t count, std::mt19937& random, std::string& firstMismatch) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const size_t rayCount = 256;
+        size_t mismatches = 0, origins = 0;
+        physics::DistanceField field;
+        field.sync(tileMap);
+
+        for (size_t tries = 0; origins < count && tries < count * 100; ++tries) {
+            float cellX = unit(random) * tileMap.getTileMapWidth(), cellY = unit(random) * tileMap.getTileMapHeight();
+            if (!tileMap.isWalkable(static_cast<size_t>(cellX), static_cast<size_t>(cellY))) continue;
+            ++origins;
+
+            sf::Vector2f origin = tileMap.getTileMapPosition() + sf::Vector2f(cellX * tileMap.getTileWidth(), cellY * tileMap.getTileHeight());
+            for (size_t i = 0; i < rayCount; ++i) {
+                float radian = 2.0f * Constants::PI * static_cast<float>(i) / static_cast<float>(rayCount);
+                sf::Vector2f direction = i % 64 ? sf::Vector2f(std::cos(radian), std::sin(radian)) : sf::Vector2f(i % 128 ? 0.0f : 1.0f, i % 128 ? 1.0f : 0.0f);
+                physics::RayHit expected = physics::castRay(tileMap, origin, direction, direction, physics::maxRayDistance);
+                std::pair<const char*, physics::RayHit> hits[] = {
+                    { "mip grid", physics::castRayMipGrid(tileMap, origin, direction, direction, physics::maxRayDistance) },
+                    { "distance field", physics::castRayDistanceField(tileMap, field, origin, direction, direction, physics::maxRayDistance) } };
+
+                for (const auto& [name, hit] : hits) {
+                    if (sameHit(hit, expected)) continue;
+                    if (!mismatches++) {
+                        firstMismatch = "origin (" + std::to_string(origin.x) + ", " + std::to_string(origin.y) + ") ray " + std::to_string(i) +
+                                        ": " + name + " cell (" + std::to_string(hit.tileX) + ", " + std::to_string(hit.tileY) + ") at " + std::to_string(hit.distance) +
+                                        ", castRay cell (" + std::to_string(expected.tileX) + ", " + std::to_string(expected.tileY) + ") at " + std::to_string(expected.distance);
+                    }
+                }
+            }
+        }
+        CHECK(origins == count); // a map that failed to load is all wall
+        return mismatches;
+    }
+
+    // cells where two fields disagree
+    size_t compareFields(const physics::DistanceField& field, const physics::DistanceField& expected, std::string& firstMismatch) {
+        size_t mismatches = 0;
+        for (size_t y = 0; y < expected.getHeight(); ++y) {
+            for (size_t x = 0; x < expected.getWidth(); ++x) {
+                if (field.getDistance(x, y) == expected.getDistance(x, y) || mismatches++) continue;
+                firstMismatch = "cell (" + std::to_string(x) + ", " + std::to_string(y) + "): " + std::to_string(field.getDistance(x, y)) +
+                                ", rebuilt " + std::to_string(expected.getDistance(x, y));
+            }
+        }
+        return mismatches;
+    }
+}
+
+TEST_CASE("castRayMipGrid and castRayDistanceField end in the same cell as castRay", "[raycast][mipgrid][distancefield]") {
+    testing::loadConfig();
+    auto tileTypes = testing::makeTileTypes();
+    std::mt19937 random(16);
+    std::string firstMismatch;
+
+    SECTION("shipped tile map") {
+        std::unique_ptr<TileMap> tileMap = testing::loadTileMap(tileTypes);
+        size_t mismatches = compareWithCastRay(*tileMap, 64, random, firstMismatch);
+        INFO(firstMismatch);
+        CHECK(mismatches == 0);
+    }
+
+    // open maps skip whole chunks and 16x16 blocks, dense ones mostly 4x4 blocks and single steps; 100x70 leaves partial chunks at the edges
+    for (float wallDensity : { 0.002f, 0.02f, 0.2f }) {
+        SECTION("random tile map, wall density " + std::to_string(wallDensity)) {
+            std::filesystem::path filePath = testing::writeTileMap("mipgrid_" + std::to_string(wallDensity), 100, 70, wallDensity, random);
+            TileMap tileMap(tileTypes.data(), Constants::TILES_NUMBER, 100, 70, Constants::TILE_WIDTH, Constants::TILE_HEIGHT, filePath, Constants::TILEMAP_POSITION);
+            size_t mismatches = compareWithCastRay(tileMap, 64, random, firstMismatch);
+            std::filesystem::remove(filePath);
+            INFO(firstMismatch);
+            CHECK(mismatches == 0);
+        }
+    }
+}
+
+// edits only recompute the cells within maxDistance of them; that has to give the field a full rebuild gives
+TEST_CASE("a distance field synced after edits equals a fresh rebuild", "[raycast][distancefield]") {
+    testing::loadConfig();
+    auto tileTypes = testing::makeTileTypes();
+    std::mt19937 random(17);
+    uint8_t wallType = 0, walkableType = 0;
+    for (uint8_t i = 0; i < Constants::TILES_NUMBER; ++i) (Constants::TILES_BOOLS[i] ? walkableType : wallType) = i;
+
+    // wide enough for two edits whose reaches don't touch
+    const size_t width = 300, height = 200;
+    const unsigned int apart = 2 * physics::DistanceField::maxDistance + 70;
+    std::filesystem::path filePath = testing::writeTileMap("distancefield", width, height, 0.01f, random);
+    TileMap tileMap(tileTypes.data(), Constants::TILES_NUMBER, width, height, Constants::TILE_WIDTH, Constants::TILE_HEIGHT, filePath, Constants::TILEMAP_POSITION);
+    std::filesystem::remove(filePath);
+
+    physics::DistanceField field;
+    field.sync(tileMap);
+    std::string firstMismatch;
+
+    // corners and edges, where the outside counts as wall, and two cells more than 2 * maxDistance apart; every cell is flipped and then flipped back
+    const std::pair<unsigned int, unsigned int> edits[] = { { 0, 0 }, { width - 1, 0 }, { 0, height - 1 }, { width - 1, height - 1 }, { width / 2, 0 },
+                                                            { 1, height / 2 }, { width - 2, height / 3 }, { width / 3, height - 1 }, { 20, 100 }, { 20 + apart, 100 } };
+    for (size_t round = 0; round < 2; ++round) {
+        uint64_t version = tileMap.getWalkableVersion();
+        for (const auto& [x, y] : edits) tileMap.setTile(x, y, tileMap.isWalkable(x, y) ? wallType : walkableType);
+
+        std::vector<sf::IntRect> changes;
+        REQUIRE(tileMap.getWalkableChangesSince(version, changes)); // so sync takes the incremental path
+        field.sync(tileMap);
+        CHECK(field.isSyncedWith(tileMap));
+
+        physics::DistanceField rebuilt;
+        rebuilt.sync(tileMap);
+        size_t mismatches = compareFields(field, rebuilt, firstMismatch);
+        INFO("round " << round << ", " << firstMismatch);
+        CHECK(mismatches == 0);
+    }
+}
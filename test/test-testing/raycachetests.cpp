@@ -0,0 +1,117 @@
+//
+//  raycachetests.cpp
+//
+//
+
+#include "unittest.hpp"
+#include "../test-src/game/physics/raycast.hpp"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // columns that don't match between what the ray cache kept and what a cast from scratch gives for the same pose
+    size_t compareWithFreshCast(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& tileMap, physics::RayTraversal traversal, const std::string& step, std::string& firstMismatch) {
+        sf::VertexArray rays;
+        physics::RayCastFrame& frame = physics::cachedRayCastFrame;
+        physics::calculateRayCast3d(player, tileMap, rays, traversal);
+        std::vector<physics::WallColumn> cached = frame.columns;
+        std::vector<float> cachedX = frame.directionX, cachedY = frame.directionY;
+
+        frame.cacheValid = false;
+        physics::calculateRayCast3d(player, tileMap, rays, traversal);
+        REQUIRE(frame.castCount == frame.columns.size());
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < cached.size(); ++i) {
+            const physics::WallColumn& column = cached[i], & fresh = frame.columns[i];
+            if (column.ray.hit == fresh.ray.hit && column.ray.tileX == fresh.ray.tileX && column.ray.tileY == fresh.ray.tileY && column.ray.side == fresh.ray.side &&
+                std::abs(column.ray.distance - fresh.ray.distance) <= 1e-2f && std::abs(column.ray.perpDistance - fresh.ray.perpDistance) <= 1e-2f &&
+                std::abs(column.wallHeight - fresh.wallHeight) <= 1e-2f * std::max(1.0f, fresh.wallHeight) && std::abs(column.shade - fresh.shade) <= 1 &&
+                std::abs(cachedX[i] - frame.directionX[i]) <= 1e-5f && std::abs(cachedY[i] - frame.directionY[i]) <= 1e-5f) continue;
+            if (!mismatches++) {
+                firstMismatch = step + ", column " + std::to_string(i) + ": cached cell (" + std::to_string(column.ray.tileX) + ", " + std::to_string(column.ray.tileY) +
+                                ") at " + std::to_string(column.ray.perpDistance) + ", fresh cell (" + std::to_string(fresh.ray.tileX) + ", " +
+                                std::to_string(fresh.ray.tileY) + ") at " + std::to_string(fresh.ray.perpDistance);
+            }
+        }
+        return mismatches;
+    }
+}
+
+// turns shift the cached columns and cast only the exposed ones, edits recast the columns that crossed them
+TEST_CASE("the ray cache gives the same columns as casting from scratch", "[raycast][raycache]") {
+    testing::loadConfig();
+    bool rayCache = Constants::RAY_CACHE;
+    Constants::RAY_CACHE = true;
+
+    auto tileTypes = testing::makeTileTypes();
+    uint8_t wallType = 0, walkableType = 0;
+    for (uint8_t i = 0; i < Constants::TILES_NUMBER; ++i) (Constants::TILES_BOOLS[i] ? walkableType : wallType) = i;
+    std::unique_ptr<Player> player = std::make_unique<Player>(sf::Vector2f(), sf::Vector2f(1.0f, 1.0f), std::make_shared<sf::Texture>(), 0.0f, sf::Vector2f(),
+                                                              std::vector<sf::IntRect>{ sf::IntRect(0, 0, 1, 1) }, 1, std::vector<std::weak_ptr<sf::Uint8[]>>());
+
+    for (physics::RayTraversal traversal : { physics::RayTraversal::DDA, physics::RayTraversal::MIPGRID, physics::RayTraversal::DISTANCE }) {
+        SECTION(physics::rayTraversalName(traversal)) {
+            std::mt19937 random(18);
+            std::filesystem::path filePath = testing::writeTileMap("raycache", 100, 70, 0.05f, random);
+            std::unique_ptr<TileMap> tileMap = std::make_unique<TileMap>(tileTypes.data(), Constants::TILES_NUMBER, 100, 70, Constants::TILE_WIDTH, Constants::TILE_HEIGHT,
+                                                                         filePath, Constants::TILEMAP_POSITION);
+            std::filesystem::remove(filePath);
+
+            /* a walkable cell away from the edges, off its center: from the center a diagonal ray runs exactly through cell
+            corners, where the last bit of its direction picks the cell and a shifted column may legitimately differ */
+            size_t cellX = 50, cellY = 35;
+            while (!tileMap->isWalkable(cellX, cellY)) cellX = 20 + random() % 60, cellY = 15 + random() % 40;
+            player->changePosition(tileMap->getTileMapPosition() + sf::Vector2f((cellX + 0.37f) * tileMap->getTileWidth(), (cellY + 0.61f) * tileMap->getTileHeight()));
+            player->updatePos();
+            player->setHeadingAngle(30.0f);
+
+            std::string firstMismatch;
+            size_t mismatches = compareWithFreshCast(player, tileMap, traversal, "first frame", firstMismatch);
+            const float angleStep = physics::cachedRayCastFrame.rayTable.getAngleStep();
+            const size_t columnCount = physics::cachedRayCastFrame.columns.size();
+
+            for (long steps : { 1L, -1L, 5L, -12L, 64L, -200L }) {
+                player->setHeadingAngle(player->getHeadingAngle() + steps * angleStep);
+                mismatches += compareWithFreshCast(player, tileMap, traversal, std::to_string(steps) + " angle steps", firstMismatch);
+            }
+            sf::VertexArray rays;
+            size_t partialCasts = 0; // turns by fewer steps than there are columns keep the rest
+            for (long steps : { 3L, -3L }) {
+                player->setHeadingAngle(player->getHeadingAngle() + steps * angleStep);
+                physics::calculateRayCast3d(player, tileMap, rays, traversal);
+                partialCasts += physics::cachedRayCastFrame.castCount == 3;
+                mismatches += compareWithFreshCast(player, tileMap, traversal, std::to_string(steps) + " angle steps after a cached frame", firstMismatch);
+            }
+            CHECK(partialCasts == 2);
+
+            // not a whole number of steps, nothing can be shifted
+            player->setHeadingAngle(player->getHeadingAngle() + 2.4f * angleStep);
+            mismatches += compareWithFreshCast(player, tileMap, traversal, "2.4 angle steps", firstMismatch);
+
+            // the wall the middle column hit opens up, then a wall appears halfway along another column's ray
+            const physics::RayHit middle = physics::cachedRayCastFrame.columns[columnCount / 2].ray;
+            if (middle.hit) tileMap->setTile(middle.tileX, middle.tileY, walkableType);
+            mismatches += compareWithFreshCast(player, tileMap, traversal, "opened wall", firstMismatch);
+
+            const physics::RayHit quarter = physics::cachedRayCastFrame.columns[columnCount / 4].ray;
+            sf::Vector2f halfway = (player->getSpritePos() + quarter.hitPoint) * 0.5f - tileMap->getTileMapPosition();
+            unsigned int halfwayX = static_cast<unsigned int>(halfway.x / tileMap->getTileWidth()), halfwayY = static_cast<unsigned int>(halfway.y / tileMap->getTileHeight());
+            if (halfwayX != cellX || halfwayY != cellY) tileMap->setTile(halfwayX, halfwayY, wallType);
+            mismatches += compareWithFreshCast(player, tileMap, traversal, "new wall", firstMismatch);
+
+            // every wall of a type turns walkable, then solid again
+            tileMap->setTileTypeWalkable(wallType, true);
+            mismatches += compareWithFreshCast(player, tileMap, traversal, "wall type walkable", firstMismatch);
+            tileMap->setTileTypeWalkable(wallType, false);
+            mismatches += compareWithFreshCast(player, tileMap, traversal, "wall type solid again", firstMismatch);
+
+            INFO(firstMismatch);
+            CHECK(mismatches == 0);
+        }
+    }
+    Constants::RAY_CACHE = rayCache;
+}
@@ -0,0 +1,75 @@
+//
+//  raypackettests.cpp
+//
+//
+
+#include "unittest.hpp"
+#include "../test-src/game/physics/raypacket.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+    bool sameColumn(const physics::WallColumn& packet, const physics::WallColumn& scalar) {
+        return packet.ray.hit == scalar.ray.hit && packet.ray.tileIndex == scalar.ray.tileIndex && packet.ray.side == scalar.ray.side &&
+               std::abs(packet.ray.distance - scalar.ray.distance) <= 1e-3f && std::abs(packet.ray.wallOffset - scalar.ray.wallOffset) <= 1e-3f &&
+               std::abs(packet.wallHeight - scalar.wallHeight) <= 1e-3f && packet.shade == scalar.shade;
+    }
+}
+
+// a full circle of rays from the centre of every walkable tile of tilemap.txt, through every kernel this CPU runs
+TEST_CASE("packet ray kernels match the scalar castRay", "[raypacket]") {
+    testing::loadConfig();
+    auto tileTypes = testing::makeTileTypes();
+    std::unique_ptr<TileMap> tileMap = testing::loadTileMap(tileTypes);
+    REQUIRE(tileMap);
+
+    const size_t rayCount = 360; // includes the axis aligned directions, where a step length is infinite
+    std::vector<float> directionX(rayCount), directionY(rayCount);
+    for (size_t i = 0; i < rayCount; ++i) {
+        float radian = 2.0f * Constants::PI * static_cast<float>(i) / static_cast<float>(rayCount);
+        directionX[i] = std::cos(radian);
+        directionY[i] = std::sin(radian);
+    }
+    directionX[0] = 1.0f; // exactly on the axes
+    directionY[0] = 0.0f;
+    directionX[rayCount / 4] = 0.0f;
+    directionY[rayCount / 4] = 1.0f;
+
+    std::vector<physics::RayKernel> kernels;
+    if (physics::detectRayKernel() != physics::RayKernel::SCALAR) kernels.push_back(physics::RayKernel::SSE);
+    if (physics::detectRayKernel() == physics::RayKernel::AVX2) kernels.push_back(physics::RayKernel::AVX2);
+
+    for (physics::RayKernel kernel : kernels) {
+        SECTION(physics::rayKernelName(kernel)) {
+            std::vector<physics::WallColumn> packetColumns(rayCount), scalarColumns(rayCount);
+            size_t rays = 0, mismatches = 0;
+            std::string firstMismatch;
+
+            for (size_t y = 0; y < tileMap->getTileMapHeight(); ++y) {
+                for (size_t x = 0; x < tileMap->getTileMapWidth(); ++x) {
+                    if (!tileMap->isWalkable(x, y)) continue;
+
+                    sf::Vector2f origin = tileMap->getTileMapPosition() + sf::Vector2f((x + 0.5f) * tileMap->getTileWidth(), (y + 0.5f) * tileMap->getTileHeight());
+                    sf::Vector2f viewDirection(directionX[rayCount / 3], directionY[rayCount / 3]);
+                    physics::castRayPacket(*tileMap, origin, directionX.data(), directionY.data(), rayCount, viewDirection, physics::maxRayDistance, packetColumns.data(), kernel);
+                    physics::castRayPacket(*tileMap, origin, directionX.data(), directionY.data(), rayCount, viewDirection, physics::maxRayDistance, scalarColumns.data(), physics::RayKernel::SCALAR);
+
+                    for (size_t i = 0; i < rayCount; ++i) {
+                        if (sameColumn(packetColumns[i], scalarColumns[i])) continue;
+                        if (!mismatches++) {
+                            firstMismatch = "tile (" + std::to_string(x) + ", " + std::to_string(y) + ") ray " + std::to_string(i) + ": distance " +
+                                            std::to_string(packetColumns[i].ray.distance) + " vs scalar " + std::to_string(scalarColumns[i].ray.distance);
+                        }
+                    }
+                    rays += rayCount;
+                }
+            }
+
+            INFO(firstMismatch);
+            CHECK(rays > 0);
+            CHECK(mismatches == 0);
+        }
+    }
+}
@@ -1 +1,45 @@
 #include "testing.hpp"
+
+#include <fstream>
+
+#if RUN_TESTING
+namespace testing {
+    void loadConfig() {
+        static bool loaded = false;
+        if (loaded) return;
+        Constants::readFromYaml(std::filesystem::path("test/test-src/game/globals/config.yaml"));
+        loaded = true;
+    }
+
+    std::array<std::shared_ptr<Tile>, Constants::TILES_NUMBER> makeTileTypes(const std::shared_ptr<sf::Texture>& texture) {
+        std::array<std::shared_ptr<Tile>, Constants::TILES_NUMBER> tiles;
+        for (unsigned short i = 0; i < Constants::TILES_NUMBER; ++i) {
+            sf::IntRect rect((i % Constants::TILES_COLUMNS) * Constants::TILE_WIDTH, (i / Constants::TILES_COLUMNS) * Constants::TILE_HEIGHT, Constants::TILE_WIDTH, Constants::TILE_HEIGHT);
+            tiles[i] = std::make_shared<Tile>(Constants::TILES_SCALE, texture, rect, std::weak_ptr<sf::Uint8[]>(), Constants::TILES_BOOLS[i]);
+        }
+        return tiles;
+    }
+
+    std::unique_ptr<TileMap> loadTileMap(std::array<std::shared_ptr<Tile>, Constants::TILES_NUMBER>& tileTypes) {
+        return std::make_unique<TileMap>(tileTypes.data(), Constants::TILES_NUMBER, Constants::TILEMAP_WIDTH, Constants::TILEMAP_HEIGHT,
+                                         Constants::TILE_WIDTH, Constants::TILE_HEIGHT, Constants::TILEMAP_FILEPATH, Constants::TILEMAP_POSITION);
+    }
+
+    std::filesystem::path writeTileMap(const std::string& name, size_t width, size_t height, float wallDensity, std::mt19937& random) {
+        std::vector<uint8_t> walkableTypes, wallTypes;
+        for (uint8_t i = 0; i < Constants::TILES_NUMBER; ++i) (Constants::TILES_BOOLS[i] ? walkableTypes : wallTypes).push_back(i);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        std::filesystem::path filePath = std::filesystem::temp_directory_path() / ("unittest_" + name + ".txt");
+        std::ofstream fileStream(filePath);
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                const std::vector<uint8_t>& types = unit(random) < wallDensity ? wallTypes : walkableTypes;
+                fileStream << static_cast<unsigned>(types[random() % types.size()]) << (x + 1 < width ? " " : "");
+            }
+            fileStream << "\n";
+        }
+        return filePath;
+    }
+}
+#endif
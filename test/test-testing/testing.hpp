@@ -2,16 +2,27 @@
 
 #define RUN_TESTING 1 // Set to 1 to enable testing, 0 to disable testing
 
-#if RUN_TESTING 
+#if RUN_TESTING
 #include <iostream>
-// #include <catch2/catch_all.hpp>
+#include <array>
+#include <memory>
+#include <random>
+#include <string>
 
+#include "../test-src/game/globals/globals.hpp"
+#include "../test-assets/tiles/tiles.hpp"
 
-// TEST_CASE("Sample Test") {
-//     REQUIRE(1 == 2);
-// }
+// shared setup of the unit tests (test-testing/*tests.cpp, make unittest) and the bench; run from the repository root like the game
+namespace testing {
+    void loadConfig(); // config.yaml once, without loading any asset
 
-#else 
+    // the tile set the scene builds, on a texture that is never created so no GL context is needed
+    std::array<std::shared_ptr<Tile>, Constants::TILES_NUMBER> makeTileTypes(const std::shared_ptr<sf::Texture>& texture = std::make_shared<sf::Texture>());
+    std::unique_ptr<TileMap> loadTileMap(std::array<std::shared_ptr<Tile>, Constants::TILES_NUMBER>& tileTypes); // the shipped tilemap.txt
+    // width x height text map in the temp directory with wallDensity of its cells on a non-walkable tile type, the rest on a walkable one
+    std::filesystem::path writeTileMap(const std::string& name, size_t width, size_t height, float wallDensity, std::mt19937& random);
+}
 
-#endif 
+#else
 
+#endif
@@ -0,0 +1,15 @@
+//
+//  unittest.hpp
+//
+//
+
+#pragma once
+
+// Catch2 3 comes from Homebrew (make install_deps); the single header of Catch2 2 works the same for these tests
+#if __has_include(<catch2/catch_all.hpp>)
+    #include <catch2/catch_all.hpp>
+#else
+    #include <catch2/catch.hpp>
+#endif
+
+#include "testing.hpp"
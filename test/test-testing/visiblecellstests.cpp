@@ -0,0 +1,83 @@
+//
+//  visiblecellstests.cpp
+//
+//
+
+#include "unittest.hpp"
+#include "../test-src/game/physics/raycast.hpp"
+
+#include <cmath>
+#include <random>
+#include <string>
+
+namespace {
+    size_t countVisible(const physics::VisibleCells& visible, const TileMap& tileMap) {
+        size_t count = 0;
+        for (size_t y = 0; y < tileMap.getTileMapHeight(); ++y) {
+            for (size_t x = 0; x < tileMap.getTileMapWidth(); ++x) count += visible.isVisible(x, y);
+        }
+        return count;
+    }
+}
+
+TEST_CASE("visible cells hold every cell the rays crossed and nothing else", "[visiblecells]") {
+    testing::loadConfig();
+    auto tileTypes = testing::makeTileTypes();
+    std::mt19937 random(20);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // far bigger than the window, with few enough walls that most rays run out at maxRayDistance
+    const size_t mapSize = 300;
+    std::filesystem::path filePath = testing::writeTileMap("visiblecells", mapSize, mapSize, 0.002f, random);
+    TileMap tileMap(tileTypes.data(), Constants::TILES_NUMBER, mapSize, mapSize, Constants::TILE_WIDTH, Constants::TILE_HEIGHT, filePath, Constants::TILEMAP_POSITION);
+    std::filesystem::remove(filePath);
+
+    physics::VisibleCells visible;
+    size_t missed = 0, listed = 0, counted = 0;
+    std::string firstMiss;
+    for (size_t frame = 0; frame < 20; ++frame) {
+        // near the edges too, where the window hangs off the map
+        sf::Vector2f origin = tileMap.getTileMapPosition() + sf::Vector2f(unit(random) * mapSize * tileMap.getTileWidth(), unit(random) * mapSize * tileMap.getTileHeight());
+        visible.begin(tileMap, origin, physics::maxRayDistance);
+
+        for (size_t i = 0; i < 128; ++i) {
+            float radian = 2.0f * Constants::PI * static_cast<float>(i) / 128.0f;
+            sf::Vector2f direction(std::cos(radian), std::sin(radian));
+            physics::RayHit ray = physics::castRay(tileMap, origin, direction, direction, physics::maxRayDistance);
+            visible.markRay(tileMap, origin, direction, ray.distance);
+            if (ray.hit) visible.markCell(ray.tileX, ray.tileY);
+
+            // points along the ray, short of where it stopped
+            for (float distance = 0.0f; distance < ray.distance - 0.5f; distance += tileMap.getTileWidth() / 8.0f) {
+                sf::Vector2f local = origin + direction * distance - tileMap.getTileMapPosition();
+                size_t x = static_cast<size_t>(local.x / tileMap.getTileWidth()), y = static_cast<size_t>(local.y / tileMap.getTileHeight());
+                if (x >= mapSize || y >= mapSize || visible.isVisible(x, y)) continue;
+                if (!missed++) firstMiss = "frame " + std::to_string(frame) + " ray " + std::to_string(i) + " cell (" + std::to_string(x) + ", " + std::to_string(y) + ")";
+            }
+            if (ray.hit && !visible.isVisible(ray.tileX, ray.tileY) && !missed++) firstMiss = "wall of frame " + std::to_string(frame) + " ray " + std::to_string(i);
+        }
+        // a cell outside the window sharing a stamp with one inside mustn't read as visible
+        listed += visible.getCells().size();
+        counted += countVisible(visible, tileMap);
+    }
+
+    INFO(firstMiss);
+    CHECK(missed == 0);
+    CHECK(counted == listed);
+
+    SECTION("the stamps don't grow with the map") {
+        std::unique_ptr<TileMap> smallMap = testing::loadTileMap(tileTypes);
+        physics::VisibleCells smallVisible;
+        smallVisible.begin(*smallMap, smallMap->getTileMapPosition(), physics::maxRayDistance);
+        CHECK(visible.getWindowSize() == smallVisible.getWindowSize());
+        CHECK(visible.getWindowSize() * visible.getWindowSize() < mapSize * mapSize);
+    }
+
+    SECTION("a new set starts empty wherever the window moved") {
+        visible.begin(tileMap, tileMap.getTileMapPosition(), physics::maxRayDistance);
+        CHECK(countVisible(visible, tileMap) == 0);
+        visible.begin(tileMap, tileMap.getTileMapPosition() + sf::Vector2f(mapSize * tileMap.getTileWidth() / 2.0f, mapSize * tileMap.getTileHeight() / 2.0f), physics::maxRayDistance);
+        CHECK(countVisible(visible, tileMap) == 0);
+        CHECK(visible.getCells().empty());
+    }
+}
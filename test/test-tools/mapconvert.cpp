@@ -0,0 +1,84 @@
+//
+//  mapconvert.cpp
+//
+//  writes the binary tile map format (tilemapfile.hpp) from the text format or from a random map made by
+//  Constants::writeRandomTileMap. tile type walkability and atlas rects come from config.yaml
+//
+//  usage: mapconvert <input.txt> <output.rcmap> [--config file]
+//         mapconvert --random <width> <height> <output.rcmap> [--seed n] [--config file]
+//
+
+#include <chrono>
+#include <cstdlib>
+
+#include "../test-src/game/globals/globals.hpp"
+#include "../test-assets/tiles/tilemapfile.hpp"
+
+namespace {
+    void printUsage() {
+        std::cerr << "usage: mapconvert <input.txt> <output.rcmap> [--config file]\n"
+                  << "       mapconvert --random <width> <height> <output.rcmap> [--seed n] [--config file]" << std::endl;
+    }
+
+    // same tile types the scene builds: atlas rects in row order, walkability from config.yaml
+    std::vector<tilemapfile::TileTypeRecord> makeTileTypeRecords() {
+        std::vector<tilemapfile::TileTypeRecord> records(Constants::TILES_NUMBER);
+        for (unsigned short i = 0; i < Constants::TILES_NUMBER; ++i) {
+            records[i].left = (i % Constants::TILES_COLUMNS) * Constants::TILE_WIDTH;
+            records[i].top = (i / Constants::TILES_COLUMNS) * Constants::TILE_HEIGHT;
+            records[i].width = Constants::TILE_WIDTH;
+            records[i].height = Constants::TILE_HEIGHT;
+            records[i].walkable = Constants::TILES_BOOLS[i] ? 1 : 0;
+        }
+        return records;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> positional;
+    std::filesystem::path configPath = "test/test-src/game/globals/config.yaml";
+    unsigned int seed = static_cast<unsigned int>(std::time(nullptr));
+    bool random = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--random") random = true;
+        else if (argument == "--config" && i + 1 < argc) configPath = argv[++i];
+        else if (argument == "--seed" && i + 1 < argc) seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else positional.push_back(argument);
+    }
+    if (positional.size() != (random ? 3u : 2u)) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        Constants::readFromYaml(configPath);
+
+        std::filesystem::path inputPath = positional[0];
+        std::filesystem::path outputPath = positional.back();
+        if (random) {
+            Constants::TILEMAP_WIDTH = std::stoul(positional[0]);
+            Constants::TILEMAP_HEIGHT = std::stoul(positional[1]);
+            inputPath = std::filesystem::temp_directory_path() / ("mapconvert_" + std::to_string(seed) + ".txt");
+            std::srand(seed);
+            Constants::writeRandomTileMap(inputPath);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        size_t width = 0, height = 0;
+        std::vector<uint16_t> cells = tilemapfile::readTextTileMap(inputPath, width, height);
+        if (random) std::filesystem::remove(inputPath);
+
+        tilemapfile::writeBinaryTileMap(outputPath, width, height, cells, makeTileTypeRecords());
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "wrote " << outputPath.string() << " (" << width << "x" << height << ", " << std::filesystem::file_size(outputPath)
+                  << " bytes) in " << seconds << "s" << std::endl;
+    } catch (const std::exception& e) {
+        log_error("Error in converting tile map: " + std::string(e.what()));
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}